@@ -0,0 +1,157 @@
+// Compares the two ways genpat can decode amd64 code: the full disassembler (operands and
+// Intel text for every instruction) against the minimal decoder the generator uses.
+// Both sweep the code section of a Windows binary and compute the segment layout,
+// then every instruction's length and segments are checked to be the same for both.
+//
+//     bench-amd64-decode GeometryDash.exe
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+#include <fmt/format.h>
+#include <MappedFile.hpp>
+#include <binaries/PE.hpp>
+#include <Zydis/Zydis.h>
+
+#include "../genpat/asm/amd64.hpp"
+
+struct SweepResult {
+    size_t instructions = 0;
+    size_t segments = 0;
+    double milliseconds = 0;
+};
+
+template <typename Decode>
+static SweepResult sweep(std::span<uint8_t const> code, Decode&& decode) {
+    constexpr int runs = 3;
+
+    SweepResult best;
+    for (int run = 0; run < runs; ++run) {
+        SweepResult result;
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t position = 0; position < code.size();) {
+            ZydisDecodedInstruction const* instruction = decode(code.subspan(position));
+            if (!instruction) {
+                ++position;
+                continue;
+            }
+
+            ZydisInstructionSegments segments;
+            ZydisGetInstructionSegments(instruction, &segments);
+            result.segments += segments.count;
+            ++result.instructions;
+            position += instruction->length;
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        result.milliseconds = std::chrono::duration<double, std::milli>(elapsed).count();
+        if (run == 0 || result.milliseconds < best.milliseconds) {
+            best = result;
+        }
+    }
+    return best;
+}
+
+// walks both decoders in lockstep and reports the first instruction they disagree on
+template <typename Expected, typename Actual>
+static bool compare(std::span<uint8_t const> code, Expected&& expected, Actual&& actual) {
+    for (size_t position = 0; position < code.size();) {
+        ZydisDecodedInstruction const* a = expected(code.subspan(position));
+        ZydisDecodedInstruction const* b = actual(code.subspan(position));
+        if (!a || !b) {
+            if (a || b) {
+                fmt::println("Decoders disagree at 0x{:x}: only {} decodes it", position, a ? "disassemble" : "minimal");
+                return false;
+            }
+            ++position;
+            continue;
+        }
+
+        if (a->length != b->length) {
+            fmt::println("Decoders disagree at 0x{:x}: length {} vs {}", position, a->length, b->length);
+            return false;
+        }
+
+        ZydisInstructionSegments segmentsA, segmentsB;
+        ZydisGetInstructionSegments(a, &segmentsA);
+        ZydisGetInstructionSegments(b, &segmentsB);
+        if (segmentsA.count != segmentsB.count) {
+            fmt::println("Decoders disagree at 0x{:x}: {} segments vs {}", position, segmentsA.count, segmentsB.count);
+            return false;
+        }
+
+        for (uint8_t i = 0; i < segmentsA.count; ++i) {
+            auto const& sa = segmentsA.segments[i];
+            auto const& sb = segmentsB.segments[i];
+            if (sa.type != sb.type || sa.offset != sb.offset || sa.size != sb.size) {
+                fmt::println("Decoders disagree at 0x{:x}: segment {} is type {} at +{} ({} bytes) vs type {} at +{} ({} bytes)",
+                    position, i,
+                    static_cast<int>(sa.type), sa.offset, sa.size,
+                    static_cast<int>(sb.type), sb.offset, sb.size
+                );
+                return false;
+            }
+        }
+
+        position += a->length;
+    }
+    return true;
+}
+
+static void report(std::string_view name, SweepResult const& result) {
+    fmt::println("{:>12}: {} instructions, {} segments in {:.1f} ms ({:.1f} ns/instruction)",
+        name,
+        result.instructions,
+        result.segments,
+        result.milliseconds,
+        result.milliseconds * 1e6 / static_cast<double>(result.instructions)
+    );
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fmt::println("Usage: {} <binary.exe>", argv[0]);
+        return 1;
+    }
+
+    auto file = utils::MappedFile::open(argv[1]);
+    if (!file) {
+        fmt::println("Failed to open binary: {}", file.unwrapErr());
+        return 1;
+    }
+
+    auto section = bin::pe::getSection(file.unwrap().data());
+    if (!section) {
+        fmt::println("Failed to read code section: {}", section.unwrapErr());
+        return 1;
+    }
+
+    auto code = section.unwrap().data;
+    fmt::println("Code section: {} bytes", code.size());
+
+    ZydisDisassembledInstruction disassembled;
+    auto disassemble = [&](std::span<uint8_t const> data) -> ZydisDecodedInstruction const* {
+        auto status = ZydisDisassembleIntel(ZYDIS_MACHINE_MODE_LONG_64, 0, data.data(), data.size(), &disassembled);
+        return ZYAN_SUCCESS(status) ? &disassembled.info : nullptr;
+    };
+
+    ZydisDecodedInstruction decoded;
+    auto decodeMinimal = [&](std::span<uint8_t const> data) -> ZydisDecodedInstruction const* {
+        return assembly::amd64::decodeInstruction(data, decoded) ? &decoded : nullptr;
+    };
+
+    auto full = sweep(code, disassemble);
+    report("disassemble", full);
+
+    auto minimal = sweep(code, decodeMinimal);
+    report("minimal", minimal);
+
+    if (!compare(code, disassemble, decodeMinimal)) {
+        return 1;
+    }
+
+    fmt::println("Speedup: {:.2f}x", full.milliseconds / minimal.milliseconds);
+    return 0;
+}
@@ -1,7 +1,12 @@
 #include "broutil.hpp"
 #include <broma.hpp>
 #include <bromascan.hpp>
+#include <deque>
 #include <fstream>
+#include <MappedFile.hpp>
+#include <PatternFile.hpp>
+#include <ScanResults.hpp>
+#include <unordered_map>
 #include <broma/Writer.hpp>
 #include <fmt/format.h>
 #include <fmt/std.h>
@@ -44,14 +49,85 @@ namespace broutil {
         return bromascan::writeBromaFile(m_outputBro, root);
     }
 
+    static void setBinding(broma::PlatformNumber& binds, Platform platform, uintptr_t offset) {
+        switch (platform) {
+            case Platform::WIN:
+                binds.win = static_cast<ptrdiff_t>(offset);
+                break;
+            case Platform::IMAC:
+                binds.imac = static_cast<ptrdiff_t>(offset);
+                break;
+            case Platform::M1:
+                binds.m1 = static_cast<ptrdiff_t>(offset);
+                break;
+            case Platform::IOS:
+                binds.ios = static_cast<ptrdiff_t>(offset);
+                break;
+            case Platform::ANDROID32:
+                binds.android32 = static_cast<ptrdiff_t>(offset);
+                break;
+            case Platform::ANDROID64:
+                binds.android64 = static_cast<ptrdiff_t>(offset);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // compact results carry no names, every Broma function is looked up by its method ID instead
+    static Result<> mergeCompactResults(broma::Root& root, std::span<uint8_t const> data) {
+        GEODE_UNWRAP_INTO(auto results, bromascan::readCompactResults(data));
+
+        std::unordered_map<uint64_t, uintptr_t> offsets;
+        offsets.reserve(results.methods.size());
+        for (auto const& method : results.methods) {
+            offsets.emplace(method.id, static_cast<uintptr_t>(method.offset));
+        }
+
+        size_t merged = 0;
+        std::vector<std::string_view> argTypes;
+        for (auto& cls : root.classes) {
+            for (auto& field : cls.fields) {
+                auto fn = field.get_as<broma::FunctionBindField>();
+                if (!fn) {
+                    continue;
+                }
+
+                argTypes.clear();
+                for (auto const& arg : fn->prototype.args) {
+                    argTypes.push_back(arg.first.name);
+                }
+
+                auto it = offsets.find(bromascan::getMethodId(cls.name, fn->prototype.name, argTypes, fn->prototype.is_const));
+                if (it == offsets.end()) {
+                    continue;
+                }
+
+                setBinding(fn->binds, results.platform, it->second);
+                fmt::println("{}::{}: set binding to offset: 0x{:X}", cls.name, fn->prototype.name, it->second);
+                ++merged;
+            }
+        }
+
+        fmt::println("Merged {} of {} scan results", merged, results.methods.size());
+        return Ok();
+    }
+
     Result<> BroUtil::mergeScanResults(broma::Root root) const {
         // load scan results
-        std::ifstream file(m_scanResults);
-        if (!file.is_open()) {
+        auto fileRes = utils::MappedFile::open(m_scanResults.string());
+        if (!fileRes) {
             return Err(fmt::format("Failed to open patterns file: {}", m_scanResults));
         }
 
-        auto jsonData = nlohmann::json::parse(file, nullptr, false);
+        auto file = std::move(fileRes).unwrap();
+        auto data = file.data();
+        if (bromascan::isCompactResults(data)) {
+            GEODE_UNWRAP(mergeCompactResults(root, data));
+            return bromascan::writeBromaFile(m_outputBro, root);
+        }
+
+        auto jsonData = nlohmann::json::parse(data.begin(), data.end(), nullptr, false);
         if (jsonData.is_discarded()) {
             return Err(fmt::format("Failed to parse patterns file: {}", m_scanResults));
         }
@@ -69,37 +145,11 @@ namespace broutil {
         }
 
         auto platformStr = jsonData["platform"].get<std::string_view>();
-        Platform platformType;
-        if (platformStr == "Windows") {
-            platformType = Platform::WIN;
-        } else if (platformStr == "iMac") {
-            platformType = Platform::IMAC;
-        } else if (platformStr == "M1") {
-            platformType = Platform::M1;
-        } else if (platformStr == "iOS") {
-            platformType = Platform::IOS;
-        } else {
+        auto platformRes = parsePlatform(platformStr);
+        if (!platformRes) {
             return Err(fmt::format("Unsupported platform in patterns file: {}", platformStr));
         }
-
-        auto setBinding = [platformType](broma::PlatformNumber& binds, uintptr_t offset) {
-            switch (platformType) {
-                case Platform::WIN:
-                    binds.win = static_cast<ptrdiff_t>(offset);
-                    break;
-                case Platform::IMAC:
-                    binds.imac = static_cast<ptrdiff_t>(offset);
-                    break;
-                case Platform::M1:
-                    binds.m1 = static_cast<ptrdiff_t>(offset);
-                    break;
-                case Platform::IOS:
-                    binds.ios = static_cast<ptrdiff_t>(offset);
-                    break;
-                default:
-                    break;
-            }
-        };
+        auto platformType = platformRes.unwrap();
 
         for (auto& classBinding : classBindings) {
             auto cls = std::ranges::find_if(
@@ -145,7 +195,7 @@ namespace broutil {
 
                 if (methodBinding.offset.has_value()) {
                     auto fn = methodIt->get_as<broma::FunctionBindField>();
-                    setBinding(fn->binds, methodBinding.offset.value());
+                    setBinding(fn->binds, platformType, methodBinding.offset.value());
                     fmt::println("    Set binding to offset: 0x{:X}", methodBinding.offset.value());
                 } else {
                     fmt::println("    No offset found in scan results.");
@@ -174,4 +224,37 @@ namespace broutil {
 
         return clearBindings(std::move(root));
     }
+
+    Result<> convertPatterns(std::filesystem::path const& input, std::filesystem::path const& output) {
+        GEODE_UNWRAP_INTO(auto data, utils::MappedFile::open(input.string()));
+
+        std::deque<bromascan::PatternClass> classes;
+        GEODE_UNWRAP_INTO(auto platform, bromascan::readPatterns(
+            data.data(), classes, [](Platform) {}, [](bromascan::PatternClass&) {}
+        ));
+
+        std::string out;
+        if (output.extension() == ".bpdb") {
+            bromascan::PatternDatabaseWriter writer;
+            for (auto const& patternClass : classes) {
+                GEODE_UNWRAP(writer.add(patternClass));
+            }
+            auto bytes = writer.finish(platform);
+            out.assign(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+        } else {
+            bromascan::PatternsJsonWriter writer(platform, false);
+            for (auto const& patternClass : classes) {
+                writer.add(patternClass);
+            }
+            out = writer.finish();
+        }
+
+        std::ofstream file(output, std::ios::binary);
+        if (!file.is_open()) {
+            return Err(fmt::format("Failed to open output file: {}", output));
+        }
+
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        return Ok();
+    }
 }
@@ -4,6 +4,10 @@
 #include <Geode/Result.hpp>
 
 namespace broutil {
+    /// Converts a patterns file between JSON and the binary pattern database,
+    /// the output format is picked by extension (`.bpdb` or anything else for JSON)
+    geode::Result<> convertPatterns(std::filesystem::path const& input, std::filesystem::path const& output);
+
     class BroUtil {
     public:
         BroUtil(
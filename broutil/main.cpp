@@ -11,7 +11,8 @@ int main(int argc, char* argv[]) {
         ("version", "Print version information")
         ("clear", "Clear all bindings from Broma file (excluding inline definitions)")
         ("append", "Append bindings from scan results file to Broma file")
-        ("format", "Reformat the Broma file");
+        ("format", "Reformat the Broma file")
+        ("convert", "Convert a patterns file between JSON and the binary pattern database (.bpdb)");
 
     auto result = options.parse(argc, argv);
     if (result.count("help")) {
@@ -67,6 +68,20 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    // convert mode
+    if (result.count("convert")) {
+        auto& inputPath = result.unmatched().at(0);
+        auto& outputPath = result.unmatched().at(1);
+
+        if (auto res = broutil::convertPatterns(inputPath, outputPath); !res) {
+            fmt::print("Error: {}\n", res.unwrapErr());
+            return 1;
+        }
+
+        fmt::print("Converted patterns file: {}\n", outputPath);
+        return 0;
+    }
+
     fmt::print("Error: No valid operation specified. Use --help for usage information.\n");
     return 1;
 }
\ No newline at end of file
@@ -1,70 +1,39 @@
 #include "aarch64.hpp"
+#include "aarch64_masks.hpp"
 
-#include <mutex>
-#include <unordered_map>
+#include <cstring>
+#include <optional>
 
+#include <fmt/format.h>
+
+#ifdef GENPAT_CAPSTONE_CROSSCHECK
+#include <atomic>
 #include <capstone/aarch64.h>
 #include <capstone/capstone.h>
-
-#include <fmt/format.h>
+#endif
 
 using namespace geode;
 
-static std::unordered_map<std::string, size_t>& getUnkInstructionMap() {
-    static auto* map = new std::unordered_map<std::string, size_t>();
-
-    static std::once_flag flag;
-    std::call_once(flag, [] {
-        std::atexit([]() {
-            std::vector<std::pair<std::string, size_t>> sorted(map->begin(), map->end());
-            std::ranges::sort(sorted, [](auto const& a, auto const& b) {
-                return b.second < a.second;
-            });
-
-            fmt::println("Unknown AArch64 instructions encountered:");
-            for (auto const& [mnemonic, count] : sorted) {
-                fmt::println("  {}: {}", mnemonic, count);
-            }
-        });
-    });
-
-    return *map;
-}
-
 namespace assembly::aarch64 {
-    bool Generator::Opcode::appendTokens(std::vector<sinaps::token_t>& outTokens) const {
-        auto masked = this->getMasked();
-        auto mask = this->m_mask;
-
-        for (size_t i = 0; i < 4; ++i) {
-            outTokens.emplace_back(masked & 0xff, mask & 0xff);
-            masked >>= 8;
-            mask >>= 8;
-        }
-
-        return true;
-    }
-
-    Result<Generator::Opcode, GenerateError> Generator::readNextOpcode() {
-        static csh handle;
-        if (!handle) {
+#ifdef GENPAT_CAPSTONE_CROSSCHECK
+    /// Mask the generator used to pick from the Capstone instruction id, kept to validate the table
+    static std::optional<uint32_t> getCapstoneMask(std::array<uint8_t, 4> const& bytes, uint64_t address) {
+        static csh handle = [] {
+            csh handle = 0;
             if (cs_open(CS_ARCH_AARCH64, CS_MODE_ARM, &handle) != CS_ERR_OK) {
                 fmt::println("Failed to initialize Capstone disassembler");
                 std::terminate();
             }
             cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON);
-            std::atexit([]() { cs_close(&handle); });
-        }
+            return handle;
+        }();
 
         thread_local cs_insn* ins = cs_malloc(handle);
 
-        auto code = m_data.data() + m_position;
-        size_t codeSize = m_data.size() - m_position;
-        uint64_t address = m_position;
-
+        auto code = bytes.data();
+        size_t codeSize = bytes.size();
         if (!cs_disasm_iter(handle, &code, &codeSize, &address, ins)) {
-            fmt::println("Failed to disassemble instruction: {}", cs_strerror(cs_errno(handle)));
-            return Err(GenerateError::NotFound);
+            return std::nullopt;
         }
 
         uint32_t mask = 0;
@@ -210,41 +179,65 @@ namespace assembly::aarch64 {
                 mask = 0b11111111'11100000'00001100'00000000;
                 break;
             }
-            default: {
-                // auto mnem = std::string_view(ins->mnemonic);
-                // if (mnem == "ldr") {
-                //     fmt::println(
-                //         "UNK [{} {}]: {:02x} {:02x} {:02x} {:02x} : {} {}",
-                //         ins->is_alias ? "alias" : "normal",
-                //         ins->is_alias ? ins->alias_id : ins->id,
-                //         ins->bytes[0], ins->bytes[1], ins->bytes[2], ins->bytes[3],
-                //         ins->mnemonic, ins->op_str
-                //     );
-                // }
-                // fmt::println(
-                //     "UNK [{} {}]: {:02x} {:02x} {:02x} {:02x} : {} {}",
-                //     ins->is_alias ? "alias" : "normal",
-                //     ins->is_alias ? ins->alias_id : ins->id,
-                //     ins->bytes[0], ins->bytes[1], ins->bytes[2], ins->bytes[3],
-                //     ins->mnemonic, ins->op_str
-                // );
-                // static std::mutex mutex;
-                // std::scoped_lock lock(mutex);
-                // getUnkInstructionMap()[ins->mnemonic]++;
+            default:
                 break;
-            }
         }
 
-        m_position += 4;
+        return mask;
+    }
 
-        return Ok(Opcode{
-            {
-                ins->bytes[0],
-                ins->bytes[1],
-                ins->bytes[2],
-                ins->bytes[3]
-            },
-            mask
-        });
+    static void crossCheck(std::array<uint8_t, 4> const& bytes, uint64_t address, std::optional<uint32_t> mask) {
+        auto expected = getCapstoneMask(bytes, address);
+        if (expected == mask) {
+            return;
+        }
+
+        static std::atomic<size_t> mismatches = 0;
+        if (mismatches++ < 100) {
+            uint32_t word;
+            std::memcpy(&word, bytes.data(), sizeof(word));
+            auto format = [](std::optional<uint32_t> mask) {
+                return mask ? fmt::format("{:08x}", mask.value()) : std::string("undecodable");
+            };
+            fmt::println("Mask mismatch for {:08x}: table {}, capstone {}", word, format(mask), format(expected));
+        }
+    }
+#endif
+
+    bool Generator::Opcode::appendBytes(std::vector<bromascan::MaskedByte>& outBytes) const {
+        auto masked = this->getMasked();
+        auto mask = this->m_mask;
+
+        for (size_t i = 0; i < 4; ++i) {
+            outBytes.emplace_back(static_cast<uint8_t>(masked & 0xff), static_cast<uint8_t>(mask & 0xff));
+            masked >>= 8;
+            mask >>= 8;
+        }
+
+        return true;
+    }
+
+    Result<Generator::Opcode, GenerateError> Generator::readNextOpcode() {
+        if (m_position + 4 > m_data.size()) {
+            return Err(GenerateError::NotFound);
+        }
+
+        std::array<uint8_t, 4> bytes;
+        std::memcpy(bytes.data(), m_data.data() + m_position, bytes.size());
+
+        uint32_t word;
+        std::memcpy(&word, bytes.data(), sizeof(word));
+        auto mask = isUnallocated(word) ? std::nullopt : std::optional(getMask(word));
+
+#ifdef GENPAT_CAPSTONE_CROSSCHECK
+        crossCheck(bytes, m_position, mask);
+#endif
+
+        if (!mask) {
+            return Err(GenerateError::NotFound);
+        }
+
+        m_position += 4;
+        return Ok(Opcode{bytes, mask.value()});
     }
 }
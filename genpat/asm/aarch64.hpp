@@ -5,12 +5,13 @@ namespace assembly::aarch64 {
     class Generator {
     public:
         static constexpr size_t IterSize = 4;
+        static constexpr size_t ScanStep = getScanStep(Architecture::AArch64);
 
         constexpr Generator(std::span<uint8_t const> data)
             : m_data(data) {}
 
         struct Opcode {
-            bool appendTokens(std::vector<sinaps::token_t>& outTokens) const;
+            bool appendBytes(std::vector<bromascan::MaskedByte>& outBytes) const;
 
             uint32_t getMasked() const {
                 return getValue() & m_mask;
@@ -0,0 +1,364 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+namespace assembly::aarch64 {
+    // Masks keyed by encoding class, decoded straight from the instruction word.
+    // They mirror what the Capstone based generator picked per instruction id (aliases included),
+    // build with GENPAT_CAPSTONE_CROSSCHECK to compare both on a real binary.
+    namespace masks {
+        constexpr uint32_t full = 0xffffffff;
+        constexpr uint32_t addSubSameReg = 0b11111111'11000000'00000011'11111111;
+        constexpr uint32_t addSubRegister = 0b11111111'11111111'11100011'11111111;
+        constexpr uint32_t addSubImmediate = 0b11111111'11111111'00000011'11111111;
+        constexpr uint32_t storePair = 0xffff8000;
+        constexpr uint32_t loadPair = 0b11111111'11000000'00000000'00000000;
+        constexpr uint32_t moveImmediate = 0xffe0fc00;
+        constexpr uint32_t branch = 0xfc000000;
+        constexpr uint32_t compareBranch = 0xff000000;
+        constexpr uint32_t load = 0xff000000;
+        constexpr uint32_t store = 0xffc00000;
+        constexpr uint32_t storeByte = 0xffe0fc00;
+        constexpr uint32_t storeUnscaled = 0b11111111'11100000'00001100'00000000;
+        constexpr uint32_t pageAddress = 0x9f000000;
+        constexpr uint32_t branchRegister = 0b11111111'11111111'11111100'00011111;
+        constexpr uint32_t testBranch = 0b11111111'11111000'00000000'00011111;
+    }
+
+    constexpr uint32_t getRd(uint32_t word) { return word & 0x1f; }
+    constexpr uint32_t getRn(uint32_t word) { return (word >> 5) & 0x1f; }
+    constexpr uint32_t getRm(uint32_t word) { return (word >> 16) & 0x1f; }
+    constexpr uint32_t getBits(uint32_t word, uint32_t low, uint32_t count) {
+        return (word >> low) & ((1u << count) - 1);
+    }
+
+    // register 31 is sp wherever it can be
+
+    constexpr uint32_t getAddSubImmediateMask(uint32_t word) {
+        bool isAdd = getBits(word, 30, 1) == 0;
+        bool isZero = getBits(word, 10, 13) == 0; // sh and imm12
+        if (isAdd && isZero && (getRd(word) == 31 || getRn(word) == 31)) {
+            return masks::full; // mov to/from sp
+        }
+        if (getRn(word) == 31) {
+            return masks::full; // stack size usually stable
+        }
+        return getRd(word) == getRn(word) ? masks::addSubSameReg : masks::addSubImmediate;
+    }
+
+    constexpr uint32_t getAddSubShiftedMask(uint32_t word) {
+        bool isSub = getBits(word, 30, 1) == 1;
+        if (isSub && getRn(word) == 31) {
+            return 0; // neg
+        }
+        return getRd(word) == getRn(word) ? masks::addSubSameReg : masks::addSubRegister;
+    }
+
+    constexpr uint32_t getAddSubExtendedMask(uint32_t word) {
+        if (getRn(word) == 31) {
+            return masks::full;
+        }
+        return getRd(word) == getRn(word) ? masks::addSubSameReg : masks::addSubRegister;
+    }
+
+    constexpr bool isPairOpcValid(uint32_t word) {
+        auto opc = getBits(word, 30, 2);
+        bool isVector = getBits(word, 26, 1);
+        return isVector ? opc != 0b11 : (opc == 0b00 || opc == 0b10);
+    }
+
+    constexpr uint32_t getPairMask(uint32_t word) {
+        auto index = getBits(word, 23, 2);
+        if (index == 0b00 || !isPairOpcValid(word)) {
+            return 0; // stnp/ldnp, stgp, ldpsw
+        }
+
+        if (getBits(word, 22, 1)) {
+            // `ldp xN, xM, [xK]` prints as an alias that never got a mask
+            return index == 0b10 && getBits(word, 15, 7) == 0 ? 0 : masks::loadPair;
+        }
+        return getRn(word) == 31 ? masks::full : masks::storePair;
+    }
+
+    enum class LoadStoreKind {
+        Other,
+        Store,
+        Load,
+        StoreByte,
+    };
+
+    constexpr LoadStoreKind getLoadStoreKind(uint32_t word) {
+        auto size = getBits(word, 30, 2);
+        auto opc = getBits(word, 22, 2);
+        if (getBits(word, 26, 1)) {
+            if (opc == 0b00) return LoadStoreKind::Store;
+            if (opc == 0b01) return LoadStoreKind::Load;
+            if (size == 0b00 && opc == 0b10) return LoadStoreKind::Store; // q
+            if (size == 0b00 && opc == 0b11) return LoadStoreKind::Load; // q
+            return LoadStoreKind::Other;
+        }
+
+        if (size == 0b00 && opc == 0b00) return LoadStoreKind::StoreByte;
+        if (size < 0b10) return LoadStoreKind::Other; // halfwords and the other byte forms
+        if (opc == 0b00) return LoadStoreKind::Store;
+        if (opc == 0b01) return LoadStoreKind::Load;
+        return LoadStoreKind::Other; // ldrsw, prfm
+    }
+
+    constexpr uint32_t getLoadStoreMask(LoadStoreKind kind, uint32_t word, bool isAlias) {
+        switch (kind) {
+            case LoadStoreKind::Store:
+            case LoadStoreKind::Load:
+                if (getRn(word) == 31) {
+                    return masks::full; // stack slots usually stable
+                }
+                return kind == LoadStoreKind::Load ? masks::load : masks::store;
+            case LoadStoreKind::StoreByte:
+                return isAlias ? 0 : masks::storeByte;
+            default:
+                return 0;
+        }
+    }
+
+    // ldr/str with an unsigned offset
+    constexpr uint32_t getLoadStoreUnsignedMask(uint32_t word) {
+        return getLoadStoreMask(getLoadStoreKind(word), word, getBits(word, 10, 12) == 0);
+    }
+
+    // ldr/str with a 9-bit signed offset or a register offset
+    constexpr uint32_t getLoadStoreOtherMask(uint32_t word) {
+        auto kind = getLoadStoreKind(word);
+        if (getBits(word, 21, 1)) {
+            if (getBits(word, 10, 2) != 0b10) {
+                return 0; // atomics
+            }
+            bool isPlainIndex = getBits(word, 13, 3) == 0b011 && getBits(word, 12, 1) == 0; // `[xN, xM]` alias
+            return getLoadStoreMask(kind, word, isPlainIndex);
+        }
+
+        switch (getBits(word, 10, 2)) {
+            case 0b00: // stur/ldur
+                if (kind != LoadStoreKind::Store || getBits(word, 12, 9) == 0) {
+                    return 0;
+                }
+                return masks::storeUnscaled;
+            case 0b10: // sttr/ldtr
+                return 0;
+            default: // pre and post index
+                return getLoadStoreMask(kind, word, false);
+        }
+    }
+
+    constexpr uint32_t getLoadLiteralMask(uint32_t word) {
+        auto opc = getBits(word, 30, 2);
+        bool isVector = getBits(word, 26, 1);
+        if (opc == 0b11 || (!isVector && opc == 0b10)) {
+            return 0; // ldrsw, prfm
+        }
+        return masks::load;
+    }
+
+    constexpr bool isMovzAlias(uint64_t value, uint32_t shift, uint32_t width) {
+        if (width == 32) {
+            value &= 0xffffffff;
+        }
+        if (value == 0 && shift != 0) {
+            return false;
+        }
+        return (value & ~(uint64_t{0xffff} << shift)) == 0;
+    }
+
+    constexpr bool isAnyMovzAlias(uint64_t value, uint32_t width) {
+        for (uint32_t shift = 0; shift <= width - 16; shift += 16) {
+            if ((value & ~(uint64_t{0xffff} << shift)) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr uint32_t getMoveWideMask(uint32_t word) {
+        auto width = getBits(word, 31, 1) ? 64u : 32u;
+        auto shift = getBits(word, 21, 2) * 16;
+        uint64_t imm = uint64_t{getBits(word, 5, 16)} << shift;
+
+        // movz is printed as mov whenever the value round trips, movn only if movz can't express it
+        if (getBits(word, 29, 2) == 0b10) {
+            return isMovzAlias(imm, shift, width) ? masks::moveImmediate : 0;
+        }
+
+        uint64_t value = ~imm;
+        if (width == 32) {
+            value &= 0xffffffff;
+        }
+        if (isAnyMovzAlias(value, width)) {
+            return 0;
+        }
+        return isMovzAlias(~value, shift, width) ? masks::moveImmediate : 0;
+    }
+
+    constexpr uint64_t decodeLogicalImmediate(uint32_t word, uint32_t width) {
+        auto n = getBits(word, 22, 1);
+        auto immr = getBits(word, 16, 6);
+        auto imms = getBits(word, 10, 6);
+
+        auto combined = (n << 6) | (~imms & 0x3f);
+        uint32_t length = 0;
+        for (uint32_t i = 0; i < 7; ++i) {
+            if (combined & (1u << i)) length = i;
+        }
+
+        uint32_t size = 1u << length;
+        uint32_t levels = size - 1;
+        uint32_t ones = (imms & levels) + 1;
+        uint32_t rotate = immr & levels;
+
+        uint64_t pattern = ones >= 64 ? ~uint64_t{0} : (uint64_t{1} << ones) - 1;
+        if (rotate != 0) {
+            auto elementMask = size == 64 ? ~uint64_t{0} : (uint64_t{1} << size) - 1;
+            pattern = ((pattern >> rotate) | (pattern << (size - rotate))) & elementMask;
+        }
+
+        for (auto bits = size; bits < width; bits *= 2) {
+            pattern |= pattern << bits;
+        }
+        return width == 32 ? pattern & 0xffffffff : pattern;
+    }
+
+    constexpr uint32_t getOrrImmediateMask(uint32_t word) {
+        if (getRn(word) != 31) {
+            return 0;
+        }
+
+        // only printed as mov when neither movz nor movn can load the value
+        auto width = getBits(word, 31, 1) ? 64u : 32u;
+        auto value = decodeLogicalImmediate(word, width);
+        auto inverted = width == 32 ? ~value & 0xffffffff : ~value;
+        if (isAnyMovzAlias(value, width) || isAnyMovzAlias(inverted, width)) {
+            return 0;
+        }
+        return masks::moveImmediate;
+    }
+
+    constexpr uint32_t getOrrShiftedMask(uint32_t word) {
+        bool isMove = getRn(word) == 31 && getBits(word, 22, 2) == 0 && getBits(word, 10, 6) == 0;
+        return isMove ? masks::full : 0;
+    }
+
+    constexpr uint32_t getUmovMask(uint32_t word) {
+        auto imm5 = getBits(word, 16, 5);
+        bool isWord = getBits(word, 30, 1) == 0 && (imm5 & 0b111) == 0b100;
+        bool isDouble = getBits(word, 30, 1) == 1 && (imm5 & 0b1111) == 0b1000;
+        return isWord || isDouble ? masks::full : 0;
+    }
+
+    constexpr uint32_t getOrrVectorMask(uint32_t word) {
+        return getRn(word) == getRm(word) ? masks::full : 0;
+    }
+
+    constexpr uint32_t getFullMask(uint32_t) { return masks::full; }
+    constexpr uint32_t getBranchMask(uint32_t) { return masks::branch; }
+    constexpr uint32_t getCompareBranchMask(uint32_t) { return masks::compareBranch; }
+    constexpr uint32_t getPageAddressMask(uint32_t) { return masks::pageAddress; }
+    constexpr uint32_t getBranchRegisterMask(uint32_t) { return masks::branchRegister; }
+    constexpr uint32_t getTestBranchMask(uint32_t) { return masks::testBranch; }
+
+    /// Instructions with `(word & match) == value`, the first matching class wins
+    struct EncodingClass {
+        uint32_t match;
+        uint32_t value;
+        uint32_t (*getMask)(uint32_t word);
+    };
+
+    constexpr std::array encodingClasses = {
+        // data processing
+        EncodingClass{0x3f800000, 0x11000000, getAddSubImmediateMask}, // add/sub (immediate)
+        EncodingClass{0x3f200000, 0x0b000000, getAddSubShiftedMask}, // add/sub (shifted register)
+        EncodingClass{0x3fe00000, 0x0b200000, getAddSubExtendedMask}, // add/sub (extended register)
+        EncodingClass{0x7f800000, 0x52800000, getMoveWideMask}, // movz
+        EncodingClass{0x7f800000, 0x12800000, getMoveWideMask}, // movn
+        EncodingClass{0x7f800000, 0x32000000, getOrrImmediateMask}, // orr (immediate)
+        EncodingClass{0x7f200000, 0x2a000000, getOrrShiftedMask}, // orr (shifted register)
+        EncodingClass{0x9f000000, 0x90000000, getPageAddressMask}, // adrp
+
+        // branches
+        EncodingClass{0x7c000000, 0x14000000, getBranchMask}, // b, bl
+        EncodingClass{0xff000010, 0x54000000, getBranchMask}, // b.cond
+        EncodingClass{0x7e000000, 0x34000000, getCompareBranchMask}, // cbz, cbnz
+        EncodingClass{0x7f000000, 0x36000000, getTestBranchMask}, // tbz
+        EncodingClass{0xfffffc1f, 0xd65f0000, getBranchRegisterMask}, // ret
+        EncodingClass{0xfffffc1f, 0xd63f0000, getBranchRegisterMask}, // blr
+        EncodingClass{0xfffffc1f, 0xd61f0000, getBranchRegisterMask}, // br
+        EncodingClass{0xffe0001f, 0xd4200000, getFullMask}, // brk
+
+        // loads and stores
+        EncodingClass{0x3a000000, 0x28000000, getPairMask}, // stp, ldp
+        EncodingClass{0x3b000000, 0x39000000, getLoadStoreUnsignedMask}, // ldr/str (unsigned offset)
+        EncodingClass{0x3b000000, 0x38000000, getLoadStoreOtherMask}, // ldr/str (imm9, register offset)
+        EncodingClass{0x3b000000, 0x18000000, getLoadLiteralMask}, // ldr (literal)
+
+        // register moves printed as mov or fmov
+        EncodingClass{0xbfe0fc00, 0x0e003c00, getUmovMask}, // umov
+        EncodingClass{0xffe0fc00, 0x4e001c00, getFullMask}, // ins (general)
+        EncodingClass{0xffe08400, 0x6e000400, getFullMask}, // ins (element)
+        EncodingClass{0xffe0fc00, 0x5e000400, getFullMask}, // dup (element, scalar)
+        EncodingClass{0xbfe0fc00, 0x0ea01c00, getOrrVectorMask}, // orr (vector)
+        EncodingClass{0xff3ffc00, 0x1e204000, getFullMask}, // fmov (register)
+        EncodingClass{0x7f36fc00, 0x1e260000, getFullMask}, // fmov (general)
+    };
+
+    /// Whether the word lies in an encoding space A64 leaves unallocated (op0 in bits 25..28),
+    /// those don't decode as any instruction and end the pattern instead of becoming a wildcard
+    constexpr bool isUnallocated(uint32_t word) {
+        switch (getBits(word, 25, 4)) {
+            case 0b0000:
+                // udf is the only instruction with bit 31 clear, the rest is SME
+                return getBits(word, 31, 1) == 0 && getBits(word, 16, 9) != 0;
+            case 0b0001:
+            case 0b0011:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /// Picks the pattern mask for an instruction, 0 if nothing of it is stable enough to keep
+    constexpr uint32_t getMask(uint32_t word) {
+        for (auto const& encoding : encodingClasses) {
+            if ((word & encoding.match) == encoding.value) {
+                return encoding.getMask(word);
+            }
+        }
+        return 0;
+    }
+
+    static_assert(getMask(0xa9bf7bfd) == masks::full); // stp x29, x30, [sp, #-0x10]!
+    static_assert(getMask(0x910003fd) == masks::full); // mov x29, sp
+    static_assert(getMask(0xd10083ff) == masks::full); // sub sp, sp, #0x20
+    static_assert(getMask(0xaa0103e0) == masks::full); // mov x0, x1
+    static_assert(getMask(0x91002000) == masks::addSubSameReg); // add x0, x0, #8
+    static_assert(getMask(0x91002020) == masks::addSubImmediate); // add x0, x1, #8
+    static_assert(getMask(0x8b020020) == masks::addSubRegister); // add x0, x1, x2
+    static_assert(getMask(0xcb0203e0) == 0); // neg x0, x2
+    static_assert(getMask(0x94000010) == masks::branch); // bl
+    static_assert(getMask(0x54000040) == masks::branch); // b.eq
+    static_assert(getMask(0xb4000040) == masks::compareBranch); // cbz x0
+    static_assert(getMask(0xd65f03c0) == masks::branchRegister); // ret
+    static_assert(getMask(0xf9400420) == masks::load); // ldr x0, [x1, #8]
+    static_assert(getMask(0xf90007e0) == masks::full); // str x0, [sp, #8]
+    static_assert(getMask(0xf9000420) == masks::store); // str x0, [x1, #8]
+    static_assert(getMask(0xa9410420) == masks::loadPair); // ldp x0, x1, [x1, #16]
+    static_assert(getMask(0x90000000) == masks::pageAddress); // adrp x0
+    static_assert(getMask(0x52800020) == masks::moveImmediate); // mov w0, #1
+    static_assert(getMask(0x12800000) == masks::moveImmediate); // mov w0, #-1
+    static_assert(getMask(0x32000000) == 0); // orr w0, w0, #1
+    static_assert(getMask(0x320003e0) == 0); // orr w0, wzr, #1 prints as mov w0, #1 via movz
+    static_assert(getMask(0x320083e0) == masks::moveImmediate); // mov w0, #0x10001
+    static_assert(getMask(0xd4200000) == masks::full); // brk #0
+    static_assert(getMask(0x1e204020) == masks::full); // fmov s0, s1
+    static_assert(getMask(0x9e670020) == masks::full); // fmov d0, x1
+    static_assert(!isUnallocated(0x00000000)); // udf #0
+    static_assert(isUnallocated(0x00010000));
+    static_assert(isUnallocated(0x02000000));
+    static_assert(!isUnallocated(0xa9bf7bfd));
+}
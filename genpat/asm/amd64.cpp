@@ -6,19 +6,34 @@ using namespace geode;
 #include <Zydis/Zydis.h>
 
 namespace assembly::amd64 {
-    bool Generator::Opcode::appendTokens(std::vector<sinaps::token_t>& outTokens) const {
+    static ZydisDecoder createDecoder() {
+        ZydisDecoder decoder;
+        ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_STACK_WIDTH_64);
+        ZydisDecoderEnableMode(&decoder, ZYDIS_DECODER_MODE_MINIMAL, ZYAN_TRUE);
+        return decoder;
+    }
+
+    bool decodeInstruction(std::span<uint8_t const> data, ZydisDecodedInstruction& outInstruction) {
+        static ZydisDecoder const decoder = createDecoder();
+
+        ZydisDecoderContext context;
+        auto status = ZydisDecoderDecodeInstruction(&decoder, &context, data.data(), data.size(), &outInstruction);
+        return ZYAN_SUCCESS(status);
+    }
+
+    bool Generator::Opcode::appendBytes(std::vector<bromascan::MaskedByte>& outBytes) const {
         auto copyBytes = [&](size_t start, size_t count, bool isWildcard = false) {
             for (size_t i = 0; i < count; ++i) {
                 if (isWildcard) {
-                    outTokens.emplace_back(sinaps::token_t::type_t::wildcard);
+                    outBytes.emplace_back(0, 0);
                 } else {
-                    outTokens.emplace_back(m_data[start + i]);
+                    outBytes.emplace_back(m_data[start + i], 0xFF);
                 }
             }
         };
 
         ZydisInstructionSegments segments;
-        ZydisGetInstructionSegments(&m_instruction.info, &segments);
+        ZydisGetInstructionSegments(&m_instruction, &segments);
 
         for (size_t i = 0; i < segments.count; ++i) {
             auto const& [type, offset, size] = segments.segments[i];
@@ -44,23 +59,16 @@ namespace assembly::amd64 {
         }
 
         auto ptr = m_data.data() + m_position;
-        auto status = ZydisDisassembleIntel(
-            ZYDIS_MACHINE_MODE_LONG_64,
-            0, ptr,
-            m_data.size() - m_position,
-            &m_lastInstruction
-        );
-
-        if (ZYAN_FAILED(status)) {
+        if (!decodeInstruction(m_data.subspan(m_position), m_lastInstruction)) {
             return Err(GenerateError::NotFound);
         }
 
         // if 0xCC (int3), return NotFound
-        if (m_lastInstruction.info.opcode == 0xCC) {
+        if (m_lastInstruction.opcode == 0xCC) {
             return Err(GenerateError::NotFound);
         }
 
-        m_position += m_lastInstruction.info.length;
+        m_position += m_lastInstruction.length;
         return Ok(Opcode{m_lastInstruction, ptr});
     }
 }
@@ -1,19 +1,24 @@
 #pragma once
-#include <Zydis/Disassembler.h>
+#include <Zydis/Decoder.h>
 
 #include "common.hpp"
 
 namespace assembly::amd64 {
+    /// Decodes one instruction in minimal mode: length, opcode and the raw segment layout only,
+    /// no operands and no formatting. The decoder is shared, it holds no state between calls.
+    bool decodeInstruction(std::span<uint8_t const> data, ZydisDecodedInstruction& outInstruction);
+
     class Generator {
     public:
         static constexpr size_t IterSize = 1;
+        static constexpr size_t ScanStep = getScanStep(Architecture::AMD64);
 
         constexpr Generator(std::span<uint8_t const> data)
             : m_data(data) {}
 
         struct Opcode {
-            bool appendTokens(std::vector<sinaps::token_t>& outTokens) const;
-            ZydisDisassembledInstruction const& m_instruction;
+            bool appendBytes(std::vector<bromascan::MaskedByte>& outBytes) const;
+            ZydisDecodedInstruction const& m_instruction;
             uint8_t const* const m_data;
         };
 
@@ -22,6 +27,6 @@ namespace assembly::amd64 {
     private:
         std::span<uint8_t const> m_data;
         size_t m_position = 0;
-        ZydisDisassembledInstruction m_lastInstruction{};
+        ZydisDecodedInstruction m_lastInstruction{};
     };
 }
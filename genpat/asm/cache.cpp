@@ -0,0 +1,63 @@
+#include "cache.hpp"
+
+#include <mutex>
+
+namespace assembly {
+    std::optional<std::span<uint32_t const>> PrefixCache::find(std::span<bromascan::MaskedByte const> prefix) const {
+        std::shared_lock lock(m_mutex);
+
+        auto node = &m_root;
+        for (auto byte : prefix) {
+            auto it = node->children.find(getKey(byte));
+            if (it == node->children.end()) {
+                return std::nullopt;
+            }
+            node = it->second.get();
+        }
+
+        // positions never change once cached, so the span stays valid after unlocking
+        if (!node->cached) {
+            return std::nullopt;
+        }
+        return node->positions;
+    }
+
+    std::optional<std::span<uint32_t const>> PrefixCache::insert(
+        std::span<bromascan::MaskedByte const> prefix,
+        std::vector<uint32_t>& positions
+    ) {
+        std::unique_lock lock(m_mutex);
+
+        auto node = &m_root;
+        size_t depth = 0;
+        for (; depth < prefix.size(); ++depth) {
+            auto it = node->children.find(getKey(prefix[depth]));
+            if (it == node->children.end()) {
+                break;
+            }
+            node = it->second.get();
+        }
+
+        // another worker might have narrowed the same prefix in the meantime
+        if (depth == prefix.size() && node->cached) {
+            return node->positions;
+        }
+
+        // cached positions are never evicted, spans to them are handed out without a lock
+        auto size = (prefix.size() - depth) * sizeof(Node) + positions.size() * sizeof(uint32_t);
+        if (m_size + size > MaxBytes) {
+            return std::nullopt;
+        }
+        m_size += size;
+
+        for (; depth < prefix.size(); ++depth) {
+            auto& child = node->children[getKey(prefix[depth])];
+            child = std::make_unique<Node>();
+            node = child.get();
+        }
+
+        node->positions = std::move(positions);
+        node->cached = true;
+        return node->positions;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <Pattern.hpp>
+
+namespace assembly {
+    /// Trie of masked pattern prefixes to every position they match in the segment.
+    /// Shared between generator workers, so methods starting with the same prologue
+    /// only pay for the segment scan once and continue from the cached positions.
+    class PrefixCache {
+    public:
+        /// Prefixes matching fewer positions than this are cheap to narrow and rarely shared
+        static constexpr size_t MinPositions = 64;
+        /// Memory the cached positions and trie nodes may take. The widest prefixes are narrowed first,
+        /// so they fill it and anything after that is narrowed by each worker on its own
+        static constexpr size_t MaxBytes = 64 << 20;
+
+        /// Returns the cached positions of `prefix`, if any worker stored them
+        [[nodiscard]] std::optional<std::span<uint32_t const>> find(std::span<bromascan::MaskedByte const> prefix) const;
+
+        /// Stores the positions of `prefix` unless they're already cached, returns the cached ones.
+        /// `positions` is only moved from when it is stored, nothing is cached once the cache is full
+        std::optional<std::span<uint32_t const>> insert(
+            std::span<bromascan::MaskedByte const> prefix,
+            std::vector<uint32_t>& positions
+        );
+
+    private:
+        struct Node {
+            std::unordered_map<uint16_t, std::unique_ptr<Node>> children; // keyed by value << 8 | mask
+            std::vector<uint32_t> positions;
+            bool cached = false;
+        };
+
+        static uint16_t getKey(bromascan::MaskedByte byte) {
+            return static_cast<uint16_t>(byte.value << 8 | byte.mask);
+        }
+
+        Node m_root;
+        size_t m_size = 0; // bytes counted against `MaxBytes`
+        mutable std::shared_mutex m_mutex;
+    };
+}
@@ -1,12 +1,31 @@
 #pragma once
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <optional>
 #include <span>
 #include <vector>
 
 #include <sinaps.hpp>
+#include <Pattern.hpp>
 #include <fmt/format.h>
 #include <Geode/Result.hpp>
 
+#include <ThreadPool.hpp>
+#include <bromascan.hpp>
+
+#include "cache.hpp"
+#include "cost.hpp"
+#include "suffix.hpp"
+
 namespace assembly {
+    /// Patterns still not unique past this many bytes are given up on
+    constexpr size_t MaxPatternSize = 256;
+
+    /// Version of the tables genpat keeps in the binary index, bump it whenever
+    /// the masks, the decoders or the cost model change what ends up in them
+    constexpr uint32_t TableVersion = 1;
+
     enum class GenerateError {
         None,
         NotFound,
@@ -35,54 +54,340 @@ namespace assembly {
         { t.readNextOpcode() } -> std::same_as<geode::Result<typename T::Opcode, GenerateError>>;
     };
 
+    /// Instructions of a whole segment, decoded once by a linear sweep. The tables are views into
+    /// the binary index when it had them, or into the storage of a sweep made in this run.
+    struct DecodedSegment {
+        std::span<bromascan::MaskedByte const> bytes; // masked like patterns, bytes that don't decode are kept as they are
+        std::span<uint8_t const> lengths; // of the instruction starting at each byte, 0 if none does
+        size_t stride = 1; // instruction alignment
+
+        std::vector<bromascan::MaskedByte> byteStorage;
+        std::vector<uint8_t> lengthStorage;
+
+        [[nodiscard]] bool empty() const { return lengths.empty(); }
+    };
+
+    /// Decodes a whole segment with the generator, chunks are swept in parallel on `pool`.
+    /// An x86 instruction crossing a chunk border is left out and only desyncs the sweep for a few bytes.
+    template <GeneratorConcept Generator>
+    DecodedSegment decodeSegment(std::span<uint8_t const> data, utils::ThreadPool& pool) {
+        constexpr size_t chunkSize = 0x40000;
+        static_assert(chunkSize % Generator::IterSize == 0);
+
+        DecodedSegment decoded;
+        decoded.byteStorage.resize(data.size());
+        decoded.lengthStorage.resize(data.size());
+        decoded.stride = Generator::IterSize;
+
+        for (size_t chunk = 0; chunk < data.size(); chunk += chunkSize) {
+            pool.enqueue([&decoded, data, chunk] {
+                auto end = std::min(chunk + chunkSize, data.size());
+                std::vector<bromascan::MaskedByte> bytes;
+
+                auto position = chunk;
+                while (position < end) {
+                    Generator gen(data.subspan(position));
+                    while (position < end) {
+                        auto opc = gen.readNextOpcode();
+                        bytes.clear();
+                        if (!opc || !opc.unwrap().appendBytes(bytes)) {
+                            break;
+                        }
+
+                        auto count = std::min(bytes.size(), end - position);
+                        if (count == bytes.size()) {
+                            decoded.lengthStorage[position] = static_cast<uint8_t>(count);
+                        }
+                        std::memcpy(decoded.byteStorage.data() + position, bytes.data(), count * sizeof(bromascan::MaskedByte));
+                        position += count;
+                    }
+
+                    // padding and data in code, keep going right after it
+                    for (size_t i = 0; i < Generator::IterSize && position < end; ++i, ++position) {
+                        decoded.byteStorage[position] = {data[position], 0xFF};
+                    }
+                }
+            });
+        }
+        pool.waitAll();
+
+        // the storage moves along with the segment, so the views stay valid
+        decoded.bytes = decoded.byteStorage;
+        decoded.lengths = decoded.lengthStorage;
+        return decoded;
+    }
+
+    /// Reads instructions from a decoded segment, falling back to the disassembler
+    /// wherever the linear sweep didn't land on the same boundary
+    template <GeneratorConcept Generator>
+    class InstructionReader {
+    public:
+        InstructionReader(std::span<uint8_t const> data, size_t position, DecodedSegment const* decoded)
+            : m_data(data), m_decoded(decoded), m_position(position) {}
+
+        /// Appends the masked bytes of the next instruction, false once there is none
+        geode::Result<bool, GenerateError> appendNext(std::vector<bromascan::MaskedByte>& out) {
+            // decoding only depends on where it starts, so any table entry matches a fresh decode
+            if (m_decoded && m_position < m_decoded->lengths.size()) {
+                if (auto length = m_decoded->lengths[m_position]) {
+                    auto bytes = std::span(m_decoded->bytes).subspan(m_position, length);
+                    out.insert(out.end(), bytes.begin(), bytes.end());
+                    m_position += length;
+                    return geode::Ok(true);
+                }
+            }
+
+            Generator gen(m_data.subspan(m_position));
+            auto opc = gen.readNextOpcode();
+            if (!opc) {
+                return geode::Ok(false);
+            }
+
+            auto size = out.size();
+            if (!opc.unwrap().appendBytes(out)) {
+                return geode::Err(GenerateError::InvalidInstruction);
+            }
+            m_position += out.size() - size;
+            return geode::Ok(true);
+        }
+
+        [[nodiscard]] size_t getPosition() const { return m_position; }
+
+    private:
+        std::span<uint8_t const> m_data;
+        DecodedSegment const* m_decoded;
+        size_t m_position;
+    };
+
+    /// Checks `pattern[from..]` against the bytes at `position`
+    inline bool matchesAt(
+        std::span<uint8_t const> data,
+        size_t position,
+        std::span<bromascan::MaskedByte const> pattern,
+        size_t from
+    ) {
+        if (position + pattern.size() > data.size()) {
+            return false;
+        }
+
+        for (size_t i = from; i < pattern.size(); ++i) {
+            if ((data[position + i] ^ pattern[i].value) & pattern[i].mask) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     template <GeneratorConcept Generator>
     geode::Result<void, GenerateError> generatePattern(
         std::vector<sinaps::token_t>& outTokens,
         std::span<uint8_t const> data,
         uintptr_t offset,
-        size_t maxSize = 256
+        DecodedSegment const* decoded = nullptr,
+        PrefixCache* prefixCache = nullptr,
+        size_t maxSize = MaxPatternSize
     ) {
-        auto start = data.data() + offset;
-        Generator gen(std::span(start, data.size() - offset));
+        InstructionReader<Generator> reader(data, offset, decoded);
 
-        intptr_t lastFound = 0;
-        intptr_t newTarget = offset;
+        // the first instruction is searched once over the whole segment, after that every
+        // instruction only re-checks the positions that still match, so a step costs O(candidates).
+        // common prefixes are looked up in the shared cache to skip straight to where methods diverge
+        std::vector<bromascan::MaskedByte> pattern;
+        std::vector<uint32_t> ownPositions;
+        std::span<uint32_t const> positions; // every match of the pattern so far, target included
 
-        while (auto opc = gen.readNextOpcode()) {
-            if (!opc.unwrap().appendTokens(outTokens)) {
-                return geode::Err(GenerateError::InvalidInstruction);
+        while (true) {
+            auto checked = pattern.size();
+            GEODE_UNWRAP_INTO(bool hasNext, reader.appendNext(pattern));
+            if (!hasNext) {
+                break;
             }
 
-            auto index = sinaps::find(data.data() + lastFound, data.size() - lastFound, outTokens, Generator::IterSize);
-            if (newTarget == index) {
-                // check if pattern is unique
-                auto nextIndex = sinaps::find(
-                    data.data() + offset + Generator::IterSize,
-                    data.size() - (offset + Generator::IterSize),
-                    outTokens,
-                    Generator::IterSize
-                );
+            auto cached = prefixCache ? prefixCache->find(pattern) : std::nullopt;
+            if (cached) {
+                positions = cached.value();
+            } else {
+                std::vector<uint32_t> narrowed;
+                if (checked == 0) {
+                    bromascan::toTokens(pattern, outTokens);
+                    for (size_t position = 0; position < data.size();) {
+                        auto index = sinaps::find(
+                            data.data() + position,
+                            data.size() - position,
+                            outTokens,
+                            Generator::IterSize
+                        );
+                        if (index == sinaps::not_found) {
+                            break;
+                        }
 
-                if (nextIndex == sinaps::not_found) {
-                    return geode::Ok();
+                        auto found = position + static_cast<size_t>(index);
+                        narrowed.push_back(static_cast<uint32_t>(found));
+                        position = found + Generator::IterSize;
+                    }
+                } else {
+                    narrowed.reserve(positions.size());
+                    std::ranges::copy_if(positions, std::back_inserter(narrowed), [&](uint32_t position) {
+                        return matchesAt(data, position, pattern, checked);
+                    });
                 }
 
-                lastFound += index;
-                newTarget = 0;
-            } else if (index != sinaps::not_found) {
-                newTarget -= index;
-                lastFound += index;
-            } else {
-                // realistically never reaches here
-                return geode::Err(GenerateError::NotFound);
+                auto stored = prefixCache && narrowed.size() >= PrefixCache::MinPositions
+                    ? prefixCache->insert(pattern, narrowed)
+                    : std::nullopt;
+                if (stored) {
+                    positions = stored.value();
+                } else {
+                    ownPositions = std::move(narrowed);
+                    positions = ownPositions;
+                }
+            }
+
+            if (positions.size() <= 1) {
+                bromascan::toTokens(pattern, outTokens);
+                return geode::Ok();
             }
 
             // if tokens exceed max size, fail
-            if (outTokens.size() > maxSize) {
+            if (pattern.size() > maxSize) {
                 return geode::Err(GenerateError::PatternTooLarge);
             }
         }
 
         return geode::Err(GenerateError::NotFound);
     }
+
+    /// Instruction boundary a unique pattern can start at
+    struct PatternStart {
+        size_t position;
+        size_t length; // bytes up to the instruction where the pattern becomes unique
+        double cost; // estimated by the scan cost model
+    };
+
+    /// Collects the instruction boundaries among the first `maxInstructions` of the function at `offset`
+    /// where a unique pattern starts, never reaching `limit`. Only boundaries scanpat looks at are kept. The suffix index gives each one's shortest
+    /// unique length, which is rounded up to whole instructions. Sorted by cost, then length, then position.
+    template <GeneratorConcept Generator>
+    std::vector<PatternStart> findPatternStarts(
+        std::span<uint8_t const> data,
+        uintptr_t offset,
+        uintptr_t limit,
+        DecodedSegment const& decoded,
+        SuffixIndex const& suffixIndex,
+        ScanCostModel const& costModel,
+        size_t maxInstructions = 8
+    ) {
+        std::vector<PatternStart> starts;
+        auto addStart = [&](size_t position) {
+            // scanpat only tries every `ScanStep` bytes, the function start is the generator's own fallback
+            if (position != offset && position % Generator::ScanStep != 0) {
+                return;
+            }
+
+            auto length = suffixIndex.getUniqueLength(position);
+            if (!length) {
+                return;
+            }
+
+            // the generator always appends whole instructions
+            auto end = position;
+            while (end < position + length.value()) {
+                if (end >= decoded.lengths.size() || decoded.lengths[end] == 0) {
+                    end = position + length.value();
+                    break;
+                }
+                end += decoded.lengths[end];
+            }
+
+            auto bytes = std::span(decoded.bytes).subspan(position, std::min(end, decoded.bytes.size()) - position);
+            starts.emplace_back(position, bytes.size(), costModel.estimate(bytes));
+        };
+
+        InstructionReader<Generator> reader(data, offset, &decoded);
+        std::vector<bromascan::MaskedByte> bytes;
+
+        addStart(offset);
+        for (size_t i = 0; i < maxInstructions; ++i) {
+            auto next = reader.appendNext(bytes);
+            if (!next || !next.unwrap()) {
+                break;
+            }
+
+            auto position = reader.getPosition();
+            if (position >= limit) {
+                break;
+            }
+            addStart(position);
+        }
+
+        std::ranges::stable_sort(starts, [](PatternStart const& a, PatternStart const& b) {
+            return a.cost != b.cost ? a.cost < b.cost : a.length < b.length;
+        });
+        return starts;
+    }
+
+    /// Generates a pattern for the function at `offset`, trying the starts from `findPatternStarts`
+    /// cheapest first. The greedy generator verifies each against the raw bytes, and the function start
+    /// is the fallback when none of them work out or the function is shorter than one instruction.
+    /// Apart from that fallback, patterns only start where scanpat looks for them (`Generator::ScanStep`).
+    /// Returns where the pattern starts.
+    template <GeneratorConcept Generator>
+    geode::Result<size_t, GenerateError> generateCheapestPattern(
+        std::vector<sinaps::token_t>& outTokens,
+        std::span<uint8_t const> data,
+        uintptr_t offset,
+        uintptr_t limit,
+        DecodedSegment const& decoded,
+        SuffixIndex const& suffixIndex,
+        ScanCostModel const& costModel,
+        PrefixCache* prefixCache = nullptr
+    ) {
+        // a start whose pattern doesn't check out is rarely followed by one that does
+        constexpr size_t maxAttempts = 3;
+
+        std::optional<GenerateError> offsetError;
+        if (!suffixIndex.empty()) {
+            auto starts = findPatternStarts<Generator>(data, offset, limit, decoded, suffixIndex, costModel);
+
+            // the suffix index already knows when no start can become unique in time, so tiny wrappers
+            // and other duplicated code fail here instead of after scanning hundreds of bytes
+            auto found = !starts.empty();
+            std::erase_if(starts, [&](PatternStart const& start) {
+                if (start.length <= MaxPatternSize) {
+                    return false;
+                }
+                if (start.position == offset) {
+                    offsetError = GenerateError::PatternTooLarge;
+                }
+                return true;
+            });
+            if (found && starts.empty()) {
+                return geode::Err(GenerateError::PatternTooLarge);
+            }
+
+            // with less than one instruction before the limit the function bounds can't be trusted,
+            // so the function start is still worth the full generator
+            auto length = offset < decoded.lengths.size() ? decoded.lengths[offset] : 0;
+            if (!found && limit > offset && limit - offset >= std::max<size_t>(length, decoded.stride)) {
+                return geode::Err(GenerateError::NotFound);
+            }
+
+            for (size_t i = 0; i < starts.size() && i < maxAttempts; ++i) {
+                auto position = starts[i].position;
+                auto res = generatePattern<Generator>(outTokens, data, position, &decoded, prefixCache);
+                if (res) {
+                    return geode::Ok(position);
+                }
+                if (position == offset) {
+                    offsetError = res.unwrapErr();
+                }
+            }
+        }
+
+        if (offsetError) {
+            return geode::Err(offsetError.value());
+        }
+        GEODE_UNWRAP(generatePattern<Generator>(outTokens, data, offset, &decoded, prefixCache));
+        return geode::Ok(offset);
+    }
 }
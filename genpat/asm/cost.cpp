@@ -0,0 +1,87 @@
+#include "cost.hpp"
+
+namespace assembly {
+    ScanCostModel ScanCostModel::build(std::span<uint8_t const> data, size_t step) {
+        return fromCounts(countBytes(data, step), data.size(), step);
+    }
+
+    std::vector<uint64_t> ScanCostModel::countBytes(std::span<uint8_t const> data, size_t step) {
+        std::vector<uint64_t> counts(step * 0x100 + 0x10000);
+        for (size_t i = 0; i < data.size(); ++i) {
+            ++counts[(i % step) * 0x100 + data[i]];
+        }
+
+        auto pairCounts = std::span(counts).subspan(step * 0x100);
+        for (size_t i = 0; i + 1 < data.size(); i += step) {
+            ++pairCounts[data[i] | data[i + 1] << 8];
+        }
+
+        return counts;
+    }
+
+    ScanCostModel ScanCostModel::fromCounts(std::span<uint64_t const> counts, size_t size, size_t step) {
+        ScanCostModel model;
+        if (size < step * 2 || counts.size() != step * 0x100 + 0x10000) {
+            return model;
+        }
+
+        model.m_step = step;
+        model.m_positions = size / step;
+
+        auto byteCounts = counts.first(step * 0x100);
+        auto pairCounts = counts.subspan(step * 0x100);
+
+        // a masked byte matches every byte that is equal on the masked bits,
+        // so each mask folds the byte frequencies onto its canonical values
+        model.m_byteProbabilities.assign(step * 0x10000, 0.f);
+        for (size_t lane = 0; lane < step; ++lane) {
+            auto laneCounts = byteCounts.subspan(lane * 0x100, 0x100);
+            auto total = static_cast<double>((size - lane + step - 1) / step);
+            auto probabilities = std::span(model.m_byteProbabilities).subspan(lane * 0x10000, 0x10000);
+            for (size_t mask = 0; mask < 0x100; ++mask) {
+                for (size_t byte = 0; byte < 0x100; ++byte) {
+                    probabilities[mask << 8 | (byte & mask)] += static_cast<float>(static_cast<double>(laneCounts[byte]) / total);
+                }
+            }
+        }
+
+        uint64_t pairs = 0;
+        for (auto count : pairCounts) {
+            pairs += count;
+        }
+
+        model.m_pairProbabilities.resize(0x10000);
+        for (size_t pair = 0; pair < 0x10000; ++pair) {
+            model.m_pairProbabilities[pair] = static_cast<float>(static_cast<double>(pairCounts[pair]) / static_cast<double>(pairs));
+        }
+
+        return model;
+    }
+
+    double ScanCostModel::estimate(std::span<bromascan::MaskedByte const> pattern) const {
+        if (this->empty()) {
+            return 0.0;
+        }
+
+        auto getProbability = [&](size_t index) -> double {
+            auto byte = pattern[index];
+            auto lane = index % m_step;
+            return m_byteProbabilities[lane * 0x10000 + (byte.mask << 8 | (byte.value & byte.mask))];
+        };
+
+        // byte k is only compared where the k bytes before it matched
+        double compared = 0.0;
+        double probability = 1.0;
+        for (size_t i = 0; i + 1 < pattern.size(); ++i) {
+            if (i == 1 && pattern[0].mask == 0xFF && pattern[1].mask == 0xFF) {
+                // the leading pair is looked up as a whole, opcode bytes are far from independent
+                probability = m_pairProbabilities[pattern[0].value | pattern[1].value << 8];
+            } else {
+                probability *= getProbability(i);
+            }
+            compared += probability;
+        }
+
+        return compared * static_cast<double>(m_positions);
+    }
+}
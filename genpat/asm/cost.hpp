@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <Pattern.hpp>
+
+namespace assembly {
+    /// Expected scanpat work for a pattern, estimated from the byte and byte pair frequencies
+    /// of the segment. A pattern starting with common bytes like `55 48 89 E5` gets compared
+    /// further at nearly every function, one starting with rare bytes is rejected right away.
+    /// `step` is the one scanpat scans at, only the positions it tries are counted.
+    class ScanCostModel {
+    public:
+        ScanCostModel() = default;
+
+        static ScanCostModel build(std::span<uint8_t const> data, size_t step);
+
+        /// Byte counts of every lane followed by the counts of the leading byte pairs,
+        /// the only pass over the segment `build` makes
+        static std::vector<uint64_t> countBytes(std::span<uint8_t const> data, size_t step);
+        /// Builds the model from `countBytes` output over a segment of `size` bytes
+        static ScanCostModel fromCounts(std::span<uint64_t const> counts, size_t size, size_t step);
+
+        /// Expected number of bytes compared past the first one when scanning the whole segment,
+        /// assuming each byte after the leading pair matches independently of the others
+        [[nodiscard]] double estimate(std::span<bromascan::MaskedByte const> pattern) const;
+
+        [[nodiscard]] bool empty() const { return m_positions == 0; }
+
+    private:
+        std::vector<float> m_byteProbabilities; // [lane][mask << 8 | value], lanes are offsets from a scanned position
+        std::vector<float> m_pairProbabilities; // [second << 8 | first] at scanned positions
+        size_t m_positions = 0; // where a pattern can start
+        size_t m_step = 1;
+    };
+}
@@ -0,0 +1,130 @@
+#include "suffix.hpp"
+
+#include <algorithm>
+
+namespace assembly {
+    SuffixIndex SuffixIndex::build(std::span<bromascan::MaskedByte const> stream, size_t stride) {
+        SuffixIndex index;
+        index.m_stride = stride;
+
+        auto n = stream.size() / stride;
+        if (n == 0) {
+            return index;
+        }
+
+        // pack every symbol into an integer, the value is canonicalized so equal masks compare equal
+        std::vector<uint64_t> symbols(n);
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t symbol = 0;
+            for (size_t k = 0; k < stride; ++k) {
+                auto byte = stream[i * stride + k];
+                symbol = symbol << 16 | (byte.value & byte.mask) << 8 | byte.mask;
+            }
+            symbols[i] = symbol;
+        }
+
+        auto& rank = index.m_rank;
+        rank.resize(n);
+        {
+            auto alphabet = symbols;
+            std::ranges::sort(alphabet);
+            auto [first, last] = std::ranges::unique(alphabet);
+            alphabet.erase(first, last);
+            for (size_t i = 0; i < n; ++i) {
+                rank[i] = static_cast<uint32_t>(std::ranges::lower_bound(alphabet, symbols[i]) - alphabet.begin());
+            }
+        }
+
+        // prefix doubling, each round sorts by (rank[i], rank[i + k]) with two counting sorts
+        std::vector<uint32_t> sa(n);
+        std::vector<uint32_t> tmp(n);
+        std::vector<uint32_t> count(n + 1);
+        for (size_t i = 0; i < n; ++i) {
+            sa[i] = static_cast<uint32_t>(i);
+        }
+        std::ranges::sort(sa, {}, [&](uint32_t i) { return rank[i]; });
+
+        auto getSecond = [&](size_t i, size_t k) -> int64_t {
+            return i + k < n ? static_cast<int64_t>(rank[i + k]) : -1;
+        };
+
+        for (size_t k = 1; k < n; k <<= 1) {
+            // suffixes without a second half sort first, the rest follow in the order of their second half
+            size_t p = 0;
+            for (size_t i = n - k; i < n; ++i) {
+                tmp[p++] = static_cast<uint32_t>(i);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                if (sa[i] >= k) {
+                    tmp[p++] = static_cast<uint32_t>(sa[i] - k);
+                }
+            }
+
+            std::ranges::fill(count, 0);
+            for (size_t i = 0; i < n; ++i) {
+                ++count[rank[i] + 1];
+            }
+            for (size_t i = 1; i <= n; ++i) {
+                count[i] += count[i - 1];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                sa[count[rank[tmp[i]]]++] = tmp[i];
+            }
+
+            tmp[sa[0]] = 0;
+            uint32_t classes = 1;
+            for (size_t i = 1; i < n; ++i) {
+                auto current = sa[i];
+                auto previous = sa[i - 1];
+                bool same = rank[current] == rank[previous] && getSecond(current, k) == getSecond(previous, k);
+                tmp[current] = same ? classes - 1 : classes++;
+            }
+            std::swap(rank, tmp);
+
+            if (classes == n) {
+                break;
+            }
+        }
+
+        // Kasai, every suffix shares at least one symbol less than its predecessor in text order did
+        auto& lcp = index.m_lcp;
+        lcp.assign(n, 0);
+        size_t h = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (rank[i] == 0) {
+                h = 0;
+                continue;
+            }
+
+            auto j = sa[rank[i] - 1];
+            while (i + h < n && j + h < n && symbols[i + h] == symbols[j + h]) {
+                ++h;
+            }
+            lcp[rank[i]] = static_cast<uint32_t>(h);
+            if (h > 0) {
+                --h;
+            }
+        }
+
+        return index;
+    }
+
+    std::optional<size_t> SuffixIndex::getUniqueLength(size_t position) const {
+        if (position % m_stride != 0 || position / m_stride >= m_rank.size()) {
+            return std::nullopt;
+        }
+
+        auto i = position / m_stride;
+        auto r = m_rank[i];
+        size_t shared = m_lcp[r];
+        if (r + 1 < m_lcp.size()) {
+            shared = std::max<size_t>(shared, m_lcp[r + 1]);
+        }
+
+        // the whole suffix is a prefix of another one
+        if (i + shared >= m_rank.size()) {
+            return std::nullopt;
+        }
+        return (shared + 1) * m_stride;
+    }
+}
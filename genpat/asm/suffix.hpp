@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <Pattern.hpp>
+
+namespace assembly {
+    /// Suffix array over the masked instruction stream of a whole segment. Answers the length of
+    /// the shortest substring starting at a position that occurs nowhere else in O(1).
+    /// Every symbol covers `stride` masked bytes, so aarch64 compares whole instructions.
+    class SuffixIndex {
+    public:
+        SuffixIndex() = default;
+
+        static SuffixIndex build(std::span<bromascan::MaskedByte const> stream, size_t stride);
+
+        /// Length in bytes of the shortest unique substring starting at `position`,
+        /// empty if every substring starting there repeats somewhere else
+        [[nodiscard]] std::optional<size_t> getUniqueLength(size_t position) const;
+
+        [[nodiscard]] size_t size() const { return m_rank.size(); }
+        [[nodiscard]] bool empty() const { return m_rank.empty(); }
+
+    private:
+        std::vector<uint32_t> m_rank; // position of each suffix in sorted order
+        std::vector<uint32_t> m_lcp; // common prefix with the previous suffix in sorted order
+        size_t m_stride = 1;
+    };
+}
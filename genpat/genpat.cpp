@@ -1,15 +1,27 @@
 #include "genpat.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <fstream>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+#include <MappedFile.hpp>
+#include <PatternFile.hpp>
+#include <PatternSet.hpp>
 #include <ThreadPool.hpp>
 #include <fmt/format.h>
 
 #include <tools.hpp>
+#include <analysis/BinaryIndex.hpp>
+#include <analysis/CallGraph.hpp>
+#include <analysis/StringXrefs.hpp>
+#include <analysis/Vtables.hpp>
+#include <binaries/ELF.hpp>
 #include <binaries/Mach-O.hpp>
 #include <binaries/PE.hpp>
 #include <broma/Reader.hpp>
 
-#include <nlohmann/json.hpp>
 
 #include "asm/aarch64.hpp"
 #include "asm/amd64.hpp"
@@ -29,6 +41,10 @@ namespace genpat {
                 return Ok(Platform::IOS);
             }
 
+            if (bin::elf::isELF(m_binaryData)) {
+                return Ok(bin::elf::isELF64(m_binaryData) ? Platform::ANDROID64 : Platform::ANDROID32);
+            }
+
             return Err("Failed to auto-detect platform from binary");
         }
         if (m_platform == "m1") {
@@ -43,23 +59,58 @@ namespace genpat {
         if (m_platform == "ios") {
             return Ok(Platform::IOS);
         }
+        if (m_platform == "android32") {
+            return Ok(Platform::ANDROID32);
+        }
+        if (m_platform == "android64") {
+            return Ok(Platform::ANDROID64);
+        }
         return Err(fmt::format("Unknown platform: {}", m_platform));
     }
 
-    Result<> Generator::savePatternFile() {
-        nlohmann::json jsonData;
-        jsonData["platform"] = format_as(m_platformType);
-        jsonData["classes"] = nlohmann::json::array();
-        for (auto const& classBinding : m_classBindings) {
-            jsonData["classes"].emplace_back(classBinding);
+    Result<> Generator::savePatternFile(utils::ThreadPool& pool) {
+        if (m_outputFile.ends_with(".bpdb")) {
+            bromascan::PatternDatabaseWriter writer;
+            for (auto const& classBinding : m_classBindings) {
+                GEODE_UNWRAP(writer.add(bromascan::PatternClass::fromBinding(classBinding)));
+            }
+            auto data = writer.finish(m_platformType);
+
+            std::ofstream file(m_outputFile, std::ios::binary);
+            if (!file.is_open()) {
+                return Err(fmt::format("Failed to open output pattern file: {}", m_outputFile));
+            }
+
+            file.write(reinterpret_cast<char const*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (m_verbose) {
+                fmt::println("Saved pattern database: {}", m_outputFile);
+            }
+
+            return Ok();
+        }
+
+        // every class is formatted into its own buffer on the pool, then written out in one go
+        std::vector<std::string> buffers(m_classBindings.size());
+        for (size_t i = 0; i < m_classBindings.size(); ++i) {
+            pool.enqueue([this, &buffers, i]() {
+                auto patternClass = bromascan::PatternClass::fromBinding(m_classBindings[i]);
+                buffers[i] = bromascan::PatternsJsonWriter::formatClass(patternClass, false);
+            });
         }
+        pool.waitAll();
+
+        bromascan::PatternsJsonWriter writer(m_platformType, false);
+        for (auto const& buffer : buffers) {
+            writer.append(buffer);
+        }
+        auto out = writer.finish();
 
         std::ofstream file(m_outputFile);
         if (!file.is_open()) {
             return Err(fmt::format("Failed to open output pattern file: {}", m_outputFile));
         }
 
-        file << jsonData.dump(2);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
         if (m_verbose) {
             fmt::println("Saved pattern file: {}", m_outputFile);
         }
@@ -79,25 +130,41 @@ namespace genpat {
         }
 
         switch (m_platformType) {
-            case Platform::M1: {
-                GEODE_UNWRAP_INTO(m_targetSegment, bin::mach::getSegment(m_binaryData, bin::mach::CPUType::ARM64));
+            case Platform::M1:
+            case Platform::IOS: {
+                GEODE_UNWRAP_INTO(m_image, bin::mach::getImage(m_binaryData, bin::mach::CPUType::ARM64));
+                GEODE_UNWRAP_INTO(auto text, bin::mach::getTextSection(m_image));
+                m_targetSegment = text.data;
+                m_baseCorrection = text.address;
                 break;
             }
             case Platform::IMAC: {
-                GEODE_UNWRAP_INTO(m_targetSegment, bin::mach::getSegment(m_binaryData, bin::mach::CPUType::X86_64));
+                GEODE_UNWRAP_INTO(m_image, bin::mach::getImage(m_binaryData, bin::mach::CPUType::X86_64));
+                GEODE_UNWRAP_INTO(auto text, bin::mach::getTextSection(m_image));
+                m_targetSegment = text.data;
+                m_baseCorrection = text.address;
                 break;
             }
             case Platform::WIN: {
                 GEODE_UNWRAP_INTO(auto virtSection, bin::pe::getSection(m_binaryData));
                 m_targetSegment = virtSection.data;
                 m_baseCorrection = virtSection.virtualAddress;
+                GEODE_UNWRAP_INTO(m_image, bin::pe::getImage(m_binaryData));
                 break;
             }
-            case Platform::IOS: {
-                GEODE_UNWRAP_INTO(m_targetSegment, bin::mach::getSegment(m_binaryData, bin::mach::CPUType::ARM64));
-                auto segmentStart = reinterpret_cast<uintptr_t>(m_targetSegment.data());
-                auto dataStart = reinterpret_cast<uintptr_t>(m_binaryData.data());
-                m_baseCorrection = segmentStart - dataStart;
+            case Platform::ANDROID32:
+            case Platform::ANDROID64: {
+                GEODE_UNWRAP_INTO(m_symbols, bin::elf::SymbolTable::build(m_binaryData));
+                GEODE_UNWRAP_INTO(m_image, bin::elf::getImage(m_binaryData, m_symbols));
+                auto text = m_image.findSection({}, ".text");
+                if (!text) {
+                    return Err("ELF file has no .text section");
+                }
+                m_targetSegment = text->data;
+                m_baseCorrection = text->address;
+                if (!m_symbols.empty() && !bin::elf::canDemangle()) {
+                    fmt::println("Warning: this build can't demangle ELF symbols, no symbol hints will be generated");
+                }
                 break;
             }
             default:
@@ -111,68 +178,140 @@ namespace genpat {
             );
         }
 
-        GEODE_UNWRAP_INTO(auto bindings, bromascan::readCodegenData(m_inputFile));
+        m_index = analysis::BinaryIndex::open(m_binaryFile, utils::hashBytes(m_binaryData), m_platformType);
+        m_stringXrefs = m_index.getStringXrefs(m_image, getArchitecture(m_platformType));
         if (m_verbose) {
-            fmt::println("Read Broma codegen data: {} classes", bindings.size());
+            fmt::println("Indexed {} string references ({} function starts)",
+                m_stringXrefs.size(),
+                m_image.functionStarts.size()
+            );
         }
 
-        static auto const getBinding = [](bromascan::Function const& method, Platform platform) -> bromascan::Address {
-            switch (platform) {
-                case Platform::M1:
-                    return method.binding.macosArm;
-                case Platform::IMAC:
-                    return method.binding.macosIntel;
-                case Platform::WIN:
-                    return method.binding.windows;
-                case Platform::IOS:
-                    return method.binding.ios;
-                default:
-                    return bromascan::Address{};
-            }
-        };
+        m_vtables = m_index.getVtables(m_image);
+        if (m_verbose) {
+            fmt::println("Indexed {} code pointers in constant data", m_vtables.size());
+        }
 
         utils::ThreadPool pool{};
+        assembly::PrefixCache prefixCache;
+
+        // every instruction is decoded once up front, generators read the table instead of
+        // the disassembler and the suffix index picks where each pattern starts
+        auto decoded = this->decodeSegment(pool);
+        auto suffixIndex = assembly::SuffixIndex::build(decoded.bytes, decoded.stride);
+        if (m_verbose && !suffixIndex.empty()) {
+            fmt::println("Built suffix index over {} masked symbols", suffixIndex.size());
+        }
+
+        // where a pattern starts is picked by how much work scanpat will have finding it
+        auto costModel = this->buildCostModel();
+
+        if (!m_previousFile.empty()) {
+            GEODE_UNWRAP(this->loadPreviousPatterns(pool));
+        }
 
-        for (auto& cls : bindings) {
-            if (cls.methods.empty()) continue; // skip empty classes to save on thread
-            m_totalMethods += std::ranges::count_if(cls.methods,
-                [&](bromascan::Function const& method) {
-                    auto address = getBinding(method, m_platformType);
-                    return address.type == bromascan::AddressType::Offset;
+        // classes are generated as soon as the reader hands them over, it only keeps
+        // the functions bound on this platform so nothing else is ever materialized
+        size_t classCount = 0;
+        auto readRes = bromascan::readCodegenData(m_inputFile, m_platformType, [&](bromascan::Class cls) {
+            ++classCount;
+            for (auto const& method : cls.methods) {
+                auto address = getAddress(method.binding, m_platformType);
+                if (address.type == bromascan::AddressType::Offset) {
+                    m_functionStarts.push_back(address.offset);
+                    ++m_totalMethods;
                 }
-            );
+            }
 
-            pool.enqueue([this, cls = std::move(cls)]() mutable {
+            pool.enqueue([this, &prefixCache, &decoded, &suffixIndex, &costModel, cls = std::move(cls)]() mutable {
                 std::vector<sinaps::token_t> outTokens;
+                std::vector<uintptr_t> addresses; // of each method in classBinding
+                std::vector<UnresolvedMethod> failed;
                 ClassBinding classBinding;
                 classBinding.name = std::move(cls.name);
 
                 for (auto const& method : cls.methods) {
-                    auto address = getBinding(method, m_platformType);
+                    auto address = getAddress(method.binding, m_platformType);
                     if (address.type != bromascan::AddressType::Offset) {
                         continue;
                     }
 
+                    // exported symbols resolve with a single lookup, no pattern needed
+                    if (auto symbol = this->findSymbol(classBinding.name, method, address.offset)) {
+                        if (m_verbose) {
+                            fmt::println("Method: {}::{} @ 0x{:x} resolved by symbol: {}",
+                                classBinding.name,
+                                method.name,
+                                address.offset,
+                                symbol.value()
+                            );
+                        }
+
+                        ++m_successfulMethods;
+                        auto& methodBinding = classBinding.methods.emplace_back();
+                        methodBinding.method = method;
+                        methodBinding.symbol = std::move(symbol);
+                        addresses.push_back(address.offset);
+                        continue;
+                    }
+
                     auto correctedOffset = address.offset - m_baseCorrection;
 
                     using namespace assembly;
-                    Result<void, GenerateError> res = Err(GenerateError::NotFound);
+                    Result<size_t, GenerateError> res = Err(GenerateError::NotFound);
+                    std::optional<uint64_t> hash;
+                    PreviousPattern const* previous = nullptr;
                     outTokens.clear();
 
-                    if (m_platformType == Platform::M1 || m_platformType == Platform::IOS) {
-                        res = generatePattern<aarch64::Generator>(
-                            outTokens,
-                            m_targetSegment,
-                            correctedOffset
-                        );
-                    } else {
-                        res = generatePattern<amd64::Generator>(
-                            outTokens,
-                            m_targetSegment,
-                            correctedOffset
-                        );
+                    // only the code section is scanned, addresses outside of it can't get a pattern
+                    if (correctedOffset < m_targetSegment.size()) {
+                        // patterns never start past the end of the function
+                        auto segmentEnd = m_baseCorrection + m_targetSegment.size();
+                        auto limit = m_image.getNextFunctionStart(address.offset).value_or(segmentEnd) - m_baseCorrection;
+
+                        // methods that didn't change keep their previous pattern if it still only matches here
+                        hash = this->hashMethod(address.offset, decoded, correctedOffset, limit);
+                        if (hash) {
+                            previous = this->findPrevious(classBinding.name, method, hash.value(), correctedOffset);
+                        }
+
+                        if (previous) {
+                            res = Ok(correctedOffset + previous->start);
+                            ++m_reusedMethods;
+                        } else {
+                            switch (getArchitecture(m_platformType)) {
+                                case Architecture::AArch64:
+                                    res = generateCheapestPattern<aarch64::Generator>(
+                                        outTokens,
+                                        m_targetSegment,
+                                        correctedOffset,
+                                        limit,
+                                        decoded,
+                                        suffixIndex,
+                                        costModel,
+                                        &prefixCache
+                                    );
+                                    break;
+                                case Architecture::AMD64:
+                                    res = generateCheapestPattern<amd64::Generator>(
+                                        outTokens,
+                                        m_targetSegment,
+                                        correctedOffset,
+                                        limit,
+                                        decoded,
+                                        suffixIndex,
+                                        costModel,
+                                        &prefixCache
+                                    );
+                                    break;
+                                case Architecture::Thumb:
+                                    break; // no Thumb-2 generator, only symbols resolve on armv7
+                            }
+                        }
                     }
 
+                    auto pattern = previous ? previous->pattern : sinaps::to_string(outTokens);
+
                     if (m_verbose) {
                         fmt::println("Method: {}::{} @ 0x{:x}",
                             classBinding.name,
@@ -183,33 +322,86 @@ namespace genpat {
                             fmt::println("Failed to generate pattern: {}", res.unwrapErr());
                         } else {
                             fmt::println(
-                                "Generated pattern ({} tokens): {}",
-                                outTokens.size(),
-                                sinaps::to_string(outTokens)
+                                "{} pattern (+0x{:x}): {}",
+                                previous ? "Reused" : "Generated",
+                                res.unwrap() - correctedOffset,
+                                pattern
                             );
                         }
                     }
 
+                    // a working pattern already resolves the method, anchors only back up the ones that fail
+                    auto anchor = res ? std::nullopt : this->findAnchor(address.offset);
+                    if (m_verbose && anchor) {
+                        fmt::println("Found string anchor: \"{}\"", anchor.value());
+                    }
+
                     if (res) {
                         ++m_successfulMethods;
                         auto& methodBinding = classBinding.methods.emplace_back();
                         methodBinding.method = method;
-                        methodBinding.pattern = sinaps::to_string(outTokens);
+                        methodBinding.pattern = std::move(pattern);
+                        methodBinding.hash = hash;
+                        methodBinding.estimate = this->estimateCost(costModel, decoded, res.unwrap(), outTokens.size(), previous);
+                        if (auto start = res.unwrap() - correctedOffset; start != 0) {
+                            methodBinding.start = static_cast<uint32_t>(start);
+                        }
+                        addresses.push_back(address.offset);
+
+                        std::scoped_lock lock(m_mutex);
+                        m_patternsByAddress.emplace(address.offset, methodBinding.pattern.value());
+                        if (m_verify) {
+                            m_emittedPatterns.emplace_back(methodBinding.pattern.value(), res.unwrap());
+                        }
+                    } else if (anchor) {
+                        ++m_successfulMethods;
+                        auto& methodBinding = classBinding.methods.emplace_back();
+                        methodBinding.method = method;
+                        methodBinding.anchor = std::move(anchor);
+                        addresses.push_back(address.offset);
                     } else {
                         ++m_failedMethods;
+                        failed.emplace_back(classBinding.name, method, address.offset);
                     }
                 }
 
-                if (classBinding.methods.empty()) {
-                    return;
-                }
+                this->assignVtableSlots(classBinding, addresses, failed);
 
                 std::scoped_lock lock(m_mutex);
-                m_classBindings.emplace_back(std::move(classBinding));
+                std::ranges::move(failed, std::back_inserter(m_unresolved));
+                if (!classBinding.methods.empty()) {
+                    m_classBindings.emplace_back(std::move(classBinding));
+                }
             });
-        }
+        });
 
         pool.waitAll();
+        GEODE_UNWRAP(std::move(readRes));
+        if (m_verbose) {
+            fmt::println("Read Broma codegen data: {} classes", classCount);
+        }
+
+        if (!m_unresolved.empty()) {
+            auto graph = m_index.getCallGraph(
+                m_targetSegment,
+                m_baseCorrection,
+                getArchitecture(m_platformType)
+            );
+
+            if (m_verbose) {
+                fmt::println("Built call graph: {} direct calls", graph.size());
+            }
+
+            this->resolveThroughCallSites(graph, pool, decoded, suffixIndex, costModel, prefixCache);
+            this->resolveThroughCallers(graph);
+        }
+        m_index.save(m_verbose);
+
+        if (!m_previousFile.empty()) {
+            fmt::println("Reused {} / {} previous patterns", m_reusedMethods.load(), m_previousPatterns.size());
+        }
+
+        size_t unverified = m_verify ? this->verifyPatterns(pool) : 0;
 
         fmt::println("Pattern generation complete: {} / {} ({:.2f}%) methods successful",
             m_successfulMethods.load(),
@@ -217,11 +409,627 @@ namespace genpat {
             (static_cast<double>(m_successfulMethods.load()) / static_cast<double>(m_totalMethods)) * 100.0
         );
 
-        GEODE_UNWRAP(this->savePatternFile());
+        GEODE_UNWRAP(this->savePatternFile(pool));
+
+        if (unverified != 0) {
+            return Err(fmt::format("{} patterns don't resolve back to their method", unverified));
+        }
+        return Ok();
+    }
+
+    assembly::DecodedSegment Generator::decodeSegment(utils::ThreadPool& pool) {
+        using namespace assembly;
+
+        // the sweep only depends on the binary, so later runs read it back from the binary index
+        DecodedSegment decoded;
+        auto bytes = m_index.read<bromascan::MaskedByte>(analysis::IndexChunk::DecodedBytes, TableVersion);
+        auto lengths = m_index.read<uint8_t>(analysis::IndexChunk::DecodedLengths, TableVersion);
+        bool cached = bytes && lengths && bytes->size() == m_targetSegment.size() && lengths->size() == bytes->size();
+
+        switch (getArchitecture(m_platformType)) {
+            case Architecture::AArch64:
+                if (!cached) {
+                    decoded = assembly::decodeSegment<aarch64::Generator>(m_targetSegment, pool);
+                }
+                decoded.stride = aarch64::Generator::IterSize;
+                break;
+            case Architecture::AMD64:
+                if (!cached) {
+                    decoded = assembly::decodeSegment<amd64::Generator>(m_targetSegment, pool);
+                }
+                decoded.stride = amd64::Generator::IterSize;
+                break;
+            case Architecture::Thumb:
+                return decoded;
+        }
+
+        if (cached) {
+            // the index stays mapped for the whole run
+            decoded.bytes = bytes.value();
+            decoded.lengths = lengths.value();
+        } else {
+            m_index.write<bromascan::MaskedByte>(analysis::IndexChunk::DecodedBytes, decoded.bytes, TableVersion);
+            m_index.write<uint8_t>(analysis::IndexChunk::DecodedLengths, decoded.lengths, TableVersion);
+        }
+
+        if (m_verbose) {
+            auto instructions = std::ranges::count_if(decoded.lengths, [](uint8_t length) { return length != 0; });
+            fmt::println("Decoded {} instructions in the code segment", instructions);
+        }
+        return decoded;
+    }
+
+    assembly::ScanCostModel Generator::buildCostModel() {
+        // counted at scanpat's step, positions it never tries cost nothing
+        auto step = getScanStep(getArchitecture(m_platformType));
+        auto counts = m_index.read<uint64_t>(analysis::IndexChunk::ByteCounts, assembly::TableVersion);
+        if (counts && counts->size() == step * 0x100 + 0x10000) {
+            return assembly::ScanCostModel::fromCounts(counts.value(), m_targetSegment.size(), step);
+        }
+
+        auto built = assembly::ScanCostModel::countBytes(m_targetSegment, step);
+        m_index.write<uint64_t>(analysis::IndexChunk::ByteCounts, built, assembly::TableVersion);
+        return assembly::ScanCostModel::fromCounts(built, m_targetSegment.size(), step);
+    }
+
+    Result<> Generator::loadPreviousPatterns(utils::ThreadPool& pool) {
+        GEODE_UNWRAP_INTO(auto file, utils::MappedFile::open(m_previousFile));
+
+        // every previous pattern is checked against the new binary in a single sweep
+        bromascan::PatternSet patterns;
+        std::vector<PreviousPattern*> entries;
+        std::deque<bromascan::PatternClass> classes;
+        GEODE_UNWRAP_INTO(auto platform, bromascan::readPatterns(file.data(), classes, [](Platform) {},
+            [&](bromascan::PatternClass& patternClass) {
+                auto const& methods = patternClass.binding.methods;
+                for (size_t i = 0; i < methods.size(); ++i) {
+                    auto const& method = methods[i];
+                    if (!method.pattern || !method.hash) {
+                        continue;
+                    }
+
+                    std::vector<bromascan::MaskedByte> bytes;
+                    if (auto stored = patternClass.getPatternBytes(i); !stored.empty()) {
+                        bytes.assign(stored.begin(), stored.end());
+                    } else if (auto parsed = bromascan::parsePattern(method.pattern.value())) {
+                        bytes = std::move(parsed.unwrap());
+                    } else {
+                        continue;
+                    }
+
+                    auto [it, inserted] = m_previousPatterns.try_emplace(
+                        getSignature(patternClass.binding.name, method.method),
+                        method.pattern.value(),
+                        bytes,
+                        method.start.value_or(0),
+                        method.hash.value()
+                    );
+                    if (inserted) {
+                        patterns.add(std::move(bytes));
+                        entries.push_back(&it->second);
+                    }
+                }
+            }
+        ));
+
+        if (platform != m_platformType) {
+            return Err(fmt::format("Previous patterns are for {}, not {}", platform, m_platformType));
+        }
 
+        auto matches = patterns.match(m_targetSegment, getScanStep(getArchitecture(m_platformType)), pool);
+        size_t unique = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (matches[i].count == 1) {
+                entries[i]->match = matches[i].first;
+                ++unique;
+            }
+        }
+
+        if (m_verbose) {
+            fmt::println("Loaded {} previous patterns, {} still unique", entries.size(), unique);
+        }
         return Ok();
     }
 
+    Generator::PreviousPattern const* Generator::findPrevious(
+        std::string_view className,
+        bromascan::Function const& method,
+        uint64_t hash,
+        size_t offset
+    ) const {
+        auto it = m_previousPatterns.find(getSignature(className, method));
+        if (it == m_previousPatterns.end()) {
+            return nullptr;
+        }
+
+        auto const& previous = it->second;
+        if (previous.hash != hash || previous.match != offset + previous.start) {
+            return nullptr;
+        }
+        return &previous;
+    }
+
+    size_t Generator::verifyPatterns(utils::ThreadPool& pool) {
+        // every emitted pattern, call sites included, is matched in a single batched pass over the segment,
+        // only trying the positions scanpat tries
+        auto scanStep = getScanStep(getArchitecture(m_platformType));
+        bromascan::PatternSet patterns;
+        std::vector<std::vector<bromascan::MaskedByte>> parsed;
+        parsed.reserve(m_emittedPatterns.size());
+        for (auto const& [pattern, offset] : m_emittedPatterns) {
+            auto bytes = bromascan::parsePattern(pattern);
+            parsed.push_back(bytes ? std::move(bytes.unwrap()) : std::vector<bromascan::MaskedByte>{});
+            patterns.add(parsed.back());
+        }
+
+        auto matches = patterns.match(m_targetSegment, scanStep, pool);
+
+        // the scan cost is measured by walking the segment like scanpat does, next to the model's `estimate`
+        std::vector<bromascan::ScanWork> work(parsed.size());
+        for (size_t i = 0; i < parsed.size(); ++i) {
+            pool.enqueue([&, i] {
+                work[i] = bromascan::measureScan(m_targetSegment, parsed[i], scanStep);
+            });
+        }
+        pool.waitAll();
+
+        size_t failed = 0;
+        std::unordered_map<std::string_view, PatternCost> costs;
+        for (size_t i = 0; i < m_emittedPatterns.size(); ++i) {
+            auto const& [pattern, offset] = m_emittedPatterns[i];
+            auto const& match = matches[i];
+            if (match.count != 1 || match.first != offset) {
+                ++failed;
+                fmt::println("Warning: pattern generated at 0x{:x} {}: {}",
+                    offset + m_baseCorrection,
+                    match.count == 0 ? "has no matches" : match.count == 1 ? "matches elsewhere" : "is not unique",
+                    pattern
+                );
+            }
+
+            constexpr uint64_t maxCost = std::numeric_limits<uint32_t>::max();
+            costs.emplace(pattern, PatternCost{
+                static_cast<uint32_t>(std::min(work[i].candidates, maxCost)),
+                static_cast<uint32_t>(std::min(work[i].compared, maxCost))
+            });
+        }
+
+        for (auto& classBinding : m_classBindings) {
+            for (auto& methodBinding : classBinding.methods) {
+                if (!methodBinding.pattern) {
+                    continue;
+                }
+
+                if (auto it = costs.find(methodBinding.pattern.value()); it != costs.end()) {
+                    methodBinding.cost = it->second;
+                }
+            }
+        }
+
+        fmt::println("Verified {} / {} patterns", m_emittedPatterns.size() - failed, m_emittedPatterns.size());
+        return failed;
+    }
+
+    uint32_t Generator::estimateCost(
+        assembly::ScanCostModel const& costModel,
+        assembly::DecodedSegment const& decoded,
+        size_t offset,
+        size_t size,
+        PreviousPattern const* previous
+    ) const {
+        std::span<bromascan::MaskedByte const> bytes;
+        if (previous) {
+            bytes = previous->bytes;
+        } else if (offset < decoded.bytes.size()) {
+            // generated patterns are the masked instructions they were read from
+            bytes = std::span(decoded.bytes).subspan(offset, std::min(size, decoded.bytes.size() - offset));
+        }
+
+        auto estimate = costModel.estimate(bytes);
+        return static_cast<uint32_t>(std::min(estimate, static_cast<double>(std::numeric_limits<uint32_t>::max())));
+    }
+
+    std::optional<uint64_t> Generator::hashMethod(
+        uintptr_t address,
+        assembly::DecodedSegment const& decoded,
+        size_t offset,
+        size_t limit
+    ) const {
+        // only the start of huge functions is hashed, reused patterns are checked against the binary anyway
+        constexpr size_t maxHashedBytes = 0x1000;
+
+        limit = std::min({limit, decoded.bytes.size(), offset + maxHashedBytes});
+        if (offset >= limit) {
+            return std::nullopt;
+        }
+
+        // masked the same way as patterns, so relocated calls and data references don't change the hash
+        auto bytes = std::span(decoded.bytes).subspan(offset, limit - offset);
+        auto hash = utils::hashBytes({reinterpret_cast<uint8_t const*>(bytes.data()), bytes.size_bytes()});
+
+        // the address is folded in so a moved method never keeps its hash
+        return hash ^ (static_cast<uint64_t>(address) * 0x9E3779B97F4A7C15);
+    }
+
+    std::optional<std::string> Generator::findSymbol(
+        std::string_view className,
+        bromascan::Function const& method,
+        uintptr_t address
+    ) const {
+        auto symbols = m_symbols.getSymbolsAt(address);
+        if (symbols.empty()) {
+            return std::nullopt;
+        }
+
+        auto prefix = fmt::format("{}::{}(", className, method.name);
+        auto signature = getSignature(className, method);
+
+        // overloads and identical-code-folded functions can share an address, prefer the exact signature
+        std::optional<std::string_view> match;
+        for (auto const& symbol : symbols) {
+            auto res = bin::elf::demangle(symbol.name);
+            if (!res) {
+                continue;
+            }
+
+            auto demangled = std::move(res).unwrap();
+            if (!demangled.starts_with(prefix)) {
+                continue;
+            }
+
+            if (demangled == signature) {
+                return std::string(symbol.name);
+            }
+
+            if (!match) {
+                match = symbol.name;
+            }
+        }
+
+        if (!match) {
+            return std::nullopt;
+        }
+        return std::string(match.value());
+    }
+
+    std::optional<std::string> Generator::findAnchor(uintptr_t address) const {
+        // short literals like "%d" are shared by too many functions to ever be unique
+        constexpr size_t minAnchorLength = 4;
+
+        // scanpat maps references back through the function starts table,
+        // so the method has to be a known function start for the anchor to resolve
+        if (m_image.getFunctionStart(address) != address) {
+            return std::nullopt;
+        }
+
+        auto end = m_image.getNextFunctionStart(address).value_or(address + 1);
+        std::vector<std::string_view> candidates;
+        for (auto const& ref : m_stringXrefs.getReferencesInRange(address, end)) {
+            auto value = m_image.readString(ref.target);
+            if (value && value->size() >= minAnchorLength) {
+                candidates.push_back(value.value());
+            }
+        }
+
+        // longer literals are less likely to be reused by new code
+        std::ranges::sort(candidates, [](std::string_view a, std::string_view b) {
+            return a.size() > b.size();
+        });
+        for (auto candidate : candidates) {
+            if (m_stringXrefs.resolve(m_image, candidate) == address) {
+                return std::string(candidate);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    void Generator::assignVtableSlots(
+        ClassBinding& classBinding,
+        std::span<uintptr_t const> addresses,
+        std::vector<UnresolvedMethod>& failed
+    ) {
+        // the anchor has to be referenced from exactly one vtable, otherwise scanpat
+        // can't tell this class apart from subclasses that don't override it
+        std::optional<analysis::Vtable> vtable;
+        for (size_t i = 0; i < addresses.size() && !vtable; ++i) {
+            if (!classBinding.methods[i].method.isVirtual) {
+                continue;
+            }
+
+            auto slots = m_vtables.getSlots(addresses[i]);
+            if (slots.size() == 1) {
+                vtable = analysis::VtableIndex::locate(m_image, slots.front().slot);
+            }
+        }
+
+        if (!vtable) {
+            return;
+        }
+
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            if (classBinding.methods[i].method.isVirtual) {
+                classBinding.methods[i].slot = vtable->find(m_image, addresses[i]);
+            }
+        }
+
+        // methods without a pattern can still be read from the vtable
+        std::erase_if(failed, [&](UnresolvedMethod& unresolved) {
+            if (!unresolved.method.isVirtual) {
+                return false;
+            }
+
+            auto slot = vtable->find(m_image, unresolved.address);
+            if (!slot) {
+                return false;
+            }
+
+            if (m_verbose) {
+                fmt::println("Method: {}::{} @ 0x{:x} resolved as vtable slot {}",
+                    unresolved.className,
+                    unresolved.method.name,
+                    unresolved.address,
+                    slot.value()
+                );
+            }
+
+            auto& methodBinding = classBinding.methods.emplace_back();
+            methodBinding.method = std::move(unresolved.method);
+            methodBinding.slot = slot;
+            ++m_successfulMethods;
+            --m_failedMethods;
+            return true;
+        });
+    }
+
+    // instruction the sweep decoded right before `position`, if there is one
+    static std::optional<size_t> getPreviousInstruction(assembly::DecodedSegment const& decoded, size_t position) {
+        constexpr size_t maxInstructionLength = 15;
+
+        for (size_t back = 1; back <= std::min(position, maxInstructionLength); ++back) {
+            auto length = decoded.lengths[position - back];
+            if (length != 0) {
+                return length == back ? std::optional(position - back) : std::nullopt;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Generator::CallSitePattern> Generator::findCallSitePattern(
+        analysis::CallGraph const& graph,
+        uintptr_t address,
+        assembly::DecodedSegment const& decoded,
+        assembly::SuffixIndex const& suffixIndex,
+        assembly::ScanCostModel const& costModel,
+        assembly::PrefixCache& prefixCache
+    ) const {
+        // call sites tried per method, the cheapest pattern among them is kept
+        constexpr size_t maxCallSites = 8;
+        // how far before the call a pattern may start
+        constexpr size_t maxLeadingInstructions = 8;
+
+        using namespace assembly;
+        auto arch = getArchitecture(m_platformType);
+        auto scanStep = getScanStep(arch);
+        std::vector<sinaps::token_t> tokens;
+
+        std::optional<CallSitePattern> best;
+        double bestCost = 0.0;
+        auto callers = graph.getCallers(address);
+        for (size_t i = 0; i < callers.size() && i < maxCallSites; ++i) {
+            size_t site = callers[i].site - m_baseCorrection;
+
+            // amd64 call sites come from a byte scan, the sweep has to agree there's a call
+            if (site >= decoded.lengths.size() || decoded.lengths[site] == 0 ||
+                analysis::decodeCall(m_targetSegment, m_baseCorrection, site, arch) != address) {
+                continue;
+            }
+
+            // the pattern may start a few instructions before the call, but stays inside the caller
+            // and starts where scanpat looks for it
+            auto callerStart = m_image.getFunctionStart(callers[i].site);
+            auto position = site;
+            std::optional<size_t> first;
+            for (size_t k = 0; ; ++k) {
+                if (position % scanStep == 0) {
+                    first = position;
+                }
+
+                auto previous = k < maxLeadingInstructions ? getPreviousInstruction(decoded, position) : std::nullopt;
+                if (!previous || (callerStart && previous.value() + m_baseCorrection < callerStart.value())) {
+                    break;
+                }
+                position = previous.value();
+            }
+
+            if (!first) {
+                continue;
+            }
+
+            Result<size_t, GenerateError> res = Err(GenerateError::NotFound);
+            switch (arch) {
+                case Architecture::AArch64:
+                    res = generateCheapestPattern<aarch64::Generator>(
+                        tokens, m_targetSegment, first.value(), site + 1, decoded, suffixIndex, costModel, &prefixCache
+                    );
+                    break;
+                case Architecture::AMD64:
+                    res = generateCheapestPattern<amd64::Generator>(
+                        tokens, m_targetSegment, first.value(), site + 1, decoded, suffixIndex, costModel, &prefixCache
+                    );
+                    break;
+                case Architecture::Thumb:
+                    break;
+            }
+
+            if (!res) {
+                continue;
+            }
+
+            // a pattern unique before the call still has to cover it, so it's extended through the call
+            auto start = res.unwrap();
+            auto end = site + decoded.lengths[site];
+            if (start + tokens.size() < end) {
+                auto missing = std::span(decoded.bytes).subspan(start + tokens.size(), end - start - tokens.size());
+                std::vector<sinaps::token_t> rest;
+                bromascan::toTokens(missing, rest);
+                tokens.insert(tokens.end(), rest.begin(), rest.end());
+            }
+
+            auto bytes = std::span(decoded.bytes).subspan(start, std::min(tokens.size(), decoded.bytes.size() - start));
+            auto cost = costModel.estimate(bytes);
+            if (!best || cost < bestCost) {
+                best = CallSitePattern{{sinaps::to_string(tokens), static_cast<uint32_t>(site - start)}, start};
+                bestCost = cost;
+            }
+        }
+
+        return best;
+    }
+
+    void Generator::resolveThroughCallSites(
+        analysis::CallGraph const& graph,
+        utils::ThreadPool& pool,
+        assembly::DecodedSegment const& decoded,
+        assembly::SuffixIndex const& suffixIndex,
+        assembly::ScanCostModel const& costModel,
+        assembly::PrefixCache& prefixCache
+    ) {
+        if (suffixIndex.empty()) {
+            return; // no generator for this architecture
+        }
+
+        std::vector<std::optional<CallSitePattern>> callSites(m_unresolved.size());
+        for (size_t i = 0; i < m_unresolved.size(); ++i) {
+            pool.enqueue([&, i] {
+                callSites[i] = this->findCallSitePattern(
+                    graph,
+                    m_unresolved[i].address,
+                    decoded,
+                    suffixIndex,
+                    costModel,
+                    prefixCache
+                );
+            });
+        }
+        pool.waitAll();
+
+        size_t resolved = 0;
+        for (size_t i = 0; i < m_unresolved.size(); ++i) {
+            if (!callSites[i]) {
+                continue;
+            }
+
+            auto& unresolved = m_unresolved[i];
+            if (m_verbose) {
+                fmt::println("Method: {}::{} @ 0x{:x} resolved through call site +0x{:x} of pattern: {}",
+                    unresolved.className,
+                    unresolved.method.name,
+                    unresolved.address,
+                    callSites[i]->callSite.offset,
+                    callSites[i]->callSite.pattern
+                );
+            }
+
+            auto classBinding = std::ranges::find(m_classBindings, unresolved.className, &ClassBinding::name);
+            if (classBinding == m_classBindings.end()) {
+                classBinding = m_classBindings.emplace(m_classBindings.end());
+                classBinding->name = unresolved.className;
+            }
+
+            auto& methodBinding = classBinding->methods.emplace_back();
+            methodBinding.method = std::move(unresolved.method);
+            methodBinding.callSite = callSites[i]->callSite;
+            if (m_verify) {
+                m_emittedPatterns.emplace_back(callSites[i]->callSite.pattern, callSites[i]->start);
+            }
+
+            ++m_successfulMethods;
+            --m_failedMethods;
+            ++resolved;
+        }
+
+        auto total = m_unresolved.size();
+        size_t index = 0;
+        std::erase_if(m_unresolved, [&](UnresolvedMethod const&) {
+            return callSites[index++].has_value();
+        });
+
+        fmt::println("Resolved {} / {} remaining methods through their call sites", resolved, total);
+    }
+
+    void Generator::resolveThroughCallers(analysis::CallGraph const& graph) {
+        // limits for how far a call site may be from the start of its caller,
+        // keeps the relation stable when the caller gets reordered between builds
+        constexpr uintptr_t maxCallerDistance = 0x2000;
+        constexpr size_t maxCallIndex = 64;
+
+        if (m_unresolved.empty()) {
+            return;
+        }
+
+        std::ranges::sort(m_functionStarts);
+
+        size_t resolved = 0;
+        for (auto& unresolved : m_unresolved) {
+            std::optional<CallerRef> best;
+            for (auto const& edge : graph.getCallers(unresolved.address)) {
+                // the caller is the closest known function that starts before the call site
+                auto it = std::ranges::upper_bound(m_functionStarts, uintptr_t{edge.site});
+                if (it == m_functionStarts.begin()) {
+                    continue;
+                }
+
+                auto callerStart = *std::prev(it);
+                if (edge.site - callerStart > maxCallerDistance) {
+                    continue;
+                }
+
+                auto pattern = m_patternsByAddress.find(callerStart);
+                if (pattern == m_patternsByAddress.end()) {
+                    continue;
+                }
+
+                auto index = graph.getCallsInRange(callerStart, edge.site).size();
+                if (index > maxCallIndex || (best && best->index <= index)) {
+                    continue;
+                }
+
+                best = CallerRef{pattern->second, index};
+            }
+
+            if (!best) {
+                continue;
+            }
+
+            if (m_verbose) {
+                fmt::println("Method: {}::{} @ 0x{:x} resolved as call #{} of pattern: {}",
+                    unresolved.className,
+                    unresolved.method.name,
+                    unresolved.address,
+                    best->index,
+                    best->pattern
+                );
+            }
+
+            auto classBinding = std::ranges::find(m_classBindings, unresolved.className, &ClassBinding::name);
+            if (classBinding == m_classBindings.end()) {
+                classBinding = m_classBindings.emplace(m_classBindings.end());
+                classBinding->name = unresolved.className;
+            }
+
+            auto& methodBinding = classBinding->methods.emplace_back();
+            methodBinding.method = std::move(unresolved.method);
+            methodBinding.caller = std::move(best);
+
+            ++m_successfulMethods;
+            --m_failedMethods;
+            ++resolved;
+        }
+
+        fmt::println("Resolved {} / {} remaining methods through their callers", resolved, m_unresolved.size());
+    }
+
     Result<> Generator::readBinaryFile() {
         std::ifstream file(m_binaryFile, std::ios::binary | std::ios::ate);
         if (!file.is_open()) {
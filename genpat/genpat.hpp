@@ -1,14 +1,34 @@
 #pragma once
 #include <atomic>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <bromascan.hpp>
+#include <Pattern.hpp>
+#include <analysis/BinaryIndex.hpp>
+#include <analysis/CallGraph.hpp>
+#include <analysis/StringXrefs.hpp>
+#include <analysis/Vtables.hpp>
+#include <binaries/ELF.hpp>
+#include <binaries/Image.hpp>
 #include <broma/Types.hpp>
 #include <Geode/Result.hpp>
 
+namespace utils {
+    class ThreadPool;
+}
+
+namespace assembly {
+    struct DecodedSegment;
+    class PrefixCache;
+    class ScanCostModel;
+    class SuffixIndex;
+}
+
 namespace genpat {
     using namespace geode;
 
@@ -19,21 +39,107 @@ namespace genpat {
             std::string binaryFile,
             std::string inputFile,
             std::string outputFile,
+            std::string previousFile,
+            bool verify,
             bool verbose
         ) : m_platform(std::move(platform)), m_binaryFile(std::move(binaryFile)), m_inputFile(std::move(inputFile)),
-            m_outputFile(std::move(outputFile)), m_verbose(verbose) {}
+            m_outputFile(std::move(outputFile)), m_previousFile(std::move(previousFile)), m_verify(verify),
+            m_verbose(verbose) {}
 
         Result<> generate();
 
     private:
         Result<> readBinaryFile();
         Result<Platform> resolvePlatform();
-        Result<> savePatternFile();
+        Result<> savePatternFile(utils::ThreadPool& pool);
+        assembly::DecodedSegment decodeSegment(utils::ThreadPool& pool);
+        assembly::ScanCostModel buildCostModel();
+
+        /// Pattern of a method in the previous patterns file, `match` is where it matches in this binary
+        struct PreviousPattern {
+            std::string pattern;
+            std::vector<bromascan::MaskedByte> bytes;
+            uint32_t start = 0;
+            uint64_t hash = 0;
+            std::optional<size_t> match;
+        };
+
+        Result<> loadPreviousPatterns(utils::ThreadPool& pool);
+        PreviousPattern const* findPrevious(
+            std::string_view className,
+            bromascan::Function const& method,
+            uint64_t hash,
+            size_t offset
+        ) const;
+        size_t verifyPatterns(utils::ThreadPool& pool);
+        uint32_t estimateCost(
+            assembly::ScanCostModel const& costModel,
+            assembly::DecodedSegment const& decoded,
+            size_t offset,
+            size_t size,
+            PreviousPattern const* previous
+        ) const;
+        std::optional<uint64_t> hashMethod(
+            uintptr_t address,
+            assembly::DecodedSegment const& decoded,
+            size_t offset,
+            size_t limit
+        ) const;
+        struct UnresolvedMethod {
+            std::string className;
+            bromascan::Function method;
+            uintptr_t address;
+        };
+
+        /// Pattern around a call to a method, `start` is where it matches in the segment
+        struct CallSitePattern {
+            CallSiteRef callSite;
+            size_t start;
+        };
+
+        std::optional<CallSitePattern> findCallSitePattern(
+            analysis::CallGraph const& graph,
+            uintptr_t address,
+            assembly::DecodedSegment const& decoded,
+            assembly::SuffixIndex const& suffixIndex,
+            assembly::ScanCostModel const& costModel,
+            assembly::PrefixCache& prefixCache
+        ) const;
+        void resolveThroughCallSites(
+            analysis::CallGraph const& graph,
+            utils::ThreadPool& pool,
+            assembly::DecodedSegment const& decoded,
+            assembly::SuffixIndex const& suffixIndex,
+            assembly::ScanCostModel const& costModel,
+            assembly::PrefixCache& prefixCache
+        );
+        void resolveThroughCallers(analysis::CallGraph const& graph);
+        void assignVtableSlots(
+            ClassBinding& classBinding,
+            std::span<uintptr_t const> addresses,
+            std::vector<UnresolvedMethod>& failed
+        );
+        std::optional<std::string> findAnchor(uintptr_t address) const;
+        std::optional<std::string> findSymbol(
+            std::string_view className,
+            bromascan::Function const& method,
+            uintptr_t address
+        ) const;
 
     private:
         std::vector<uint8_t> m_binaryData;
         std::span<uint8_t const> m_targetSegment;
+        bin::Image m_image;
+        analysis::BinaryIndex m_index;
+        analysis::StringXrefs m_stringXrefs;
+        analysis::VtableIndex m_vtables;
+        bin::elf::SymbolTable m_symbols;
         std::vector<ClassBinding> m_classBindings;
+        std::vector<UnresolvedMethod> m_unresolved;
+        std::vector<uintptr_t> m_functionStarts;
+        std::unordered_map<uintptr_t, std::string> m_patternsByAddress;
+        std::unordered_map<std::string, PreviousPattern> m_previousPatterns; // by method signature
+        std::vector<std::pair<std::string, size_t>> m_emittedPatterns; // and where they start in the segment
         std::mutex m_mutex;
         intptr_t m_baseCorrection = 0;
         Platform m_platformType = Platform::WIN;
@@ -41,11 +147,14 @@ namespace genpat {
         size_t m_totalMethods = 0;
         std::atomic<size_t> m_successfulMethods = 0;
         std::atomic<size_t> m_failedMethods = 0;
+        std::atomic<size_t> m_reusedMethods = 0;
 
         std::string m_platform;
         std::string m_binaryFile;
         std::string m_inputFile;
         std::string m_outputFile;
+        std::string m_previousFile;
+        bool m_verify;
         bool m_verbose;
     };
 }
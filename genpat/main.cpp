@@ -8,8 +8,10 @@ int main(int argc, char* argv[]) {
     options.add_options()
         ("v,verbose", "Enable verbose output")
         ("h,help", "Print help")
-        ("p,platform", "Target platform (auto, m1, imac, win, ios)", cxxopts::value<std::string>()->default_value("auto"))
+        ("p,platform", "Target platform (auto, m1, imac, win, ios, android32, android64)", cxxopts::value<std::string>()->default_value("auto"))
         ("version", "Print version information")
+        ("verify", "Check that every emitted pattern resolves back to its method and record its scan cost")
+        ("previous", "Previous patterns file, methods that didn't change keep their pattern", cxxopts::value<std::string>()->default_value(""))
         ("binary", "Binary File", cxxopts::value<std::string>())
         ("input", "Input Bindings", cxxopts::value<std::string>())
         ("output", "Output Patterns File", cxxopts::value<std::string>());
@@ -37,6 +39,8 @@ int main(int argc, char* argv[]) {
     auto binaryFile = result["binary"].as<std::string>();
     auto inputFile = result["input"].as<std::string>();
     auto outputFile = result["output"].as<std::string>();
+    auto previousFile = result["previous"].as<std::string>();
+    bool verify = result.count("verify") > 0;
     bool verbose = result.count("verbose") > 0;
 
     if (verbose) {
@@ -44,6 +48,9 @@ int main(int argc, char* argv[]) {
         fmt::print("Binary File: {}\n", binaryFile);
         fmt::print("Input File: {}\n", inputFile);
         fmt::print("Output File: {}\n", outputFile);
+        if (!previousFile.empty()) {
+            fmt::print("Previous File: {}\n", previousFile);
+        }
     }
 
     auto start = std::chrono::high_resolution_clock::now();
@@ -53,6 +60,8 @@ int main(int argc, char* argv[]) {
         std::move(binaryFile),
         std::move(inputFile),
         std::move(outputFile),
+        std::move(previousFile),
+        verify,
         verbose
     );
 
@@ -1,5 +1,6 @@
 #include <chrono>
 #include <cxxopts.hpp>
+#include <vector>
 #include <fmt/format.h>
 #include "scanpat.hpp"
 
@@ -10,9 +11,9 @@ int main(int argc, char* argv[]) {
         ("h,help", "Print help")
         ("version", "Print version information")
         ("binary", "Binary File", cxxopts::value<std::string>())
-        ("patterns", "Input Patterns File", cxxopts::value<std::string>())
-        ("output", "Output Scan Results File", cxxopts::value<std::string>());
-    options.parse_positional({"binary", "patterns", "output"});
+        ("jobs", "Pairs of input patterns file and output scan results file", cxxopts::value<std::vector<std::string>>());
+    options.parse_positional({"binary", "jobs"});
+    options.positional_help("<binary> <patterns> <output> [<patterns> <output> ...]");
     auto result = options.parse(argc, argv);
 
     if (result.count("help")) {
@@ -25,31 +26,35 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
-    if (!result.count("binary") || !result.count("patterns") || !result.count("output")) {
+    if (!result.count("binary") || !result.count("jobs")) {
         fmt::print("Error: Missing required arguments.\n");
         fmt::print("{}", options.help());
         return 1;
     }
 
+    auto const& jobArgs = result["jobs"].as<std::vector<std::string>>();
+    if (jobArgs.size() % 2 != 0) {
+        fmt::print("Error: Every patterns file needs a matching output file.\n");
+        fmt::print("{}", options.help());
+        return 1;
+    }
+
+    std::vector<scanpat::ScanJob> jobs;
+    for (size_t i = 0; i < jobArgs.size(); i += 2) {
+        jobs.push_back({jobArgs[i], jobArgs[i + 1]});
+    }
+
     auto binaryFile = result["binary"].as<std::string>();
-    auto patternsFile = result["patterns"].as<std::string>();
-    auto outputFile = result["output"].as<std::string>();
     bool verbose = result.count("verbose") > 0;
     if (verbose) {
         fmt::print("Binary File: {}\n", binaryFile);
-        fmt::print("Patterns File: {}\n", patternsFile);
-        fmt::print("Output File: {}\n", outputFile);
+        for (auto const& job : jobs) {
+            fmt::print("Patterns File: {} -> Output File: {}\n", job.patternsFile, job.outputFile);
+        }
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    scanpat::Scanner scanner(
-        std::move(binaryFile),
-        std::move(patternsFile),
-        std::move(outputFile),
-        verbose
-    );
-
-    if (auto res = scanner.scan(); !res) {
+    if (auto res = scanpat::scanAll(binaryFile, jobs, verbose); !res) {
         fmt::print("Error: {}\n", res.unwrapErr());
         return 1;
     }
@@ -1,9 +1,21 @@
 #include "scanpat.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
+#include <ranges>
+#include <unordered_map>
 
 #include <sinaps.hpp>
+#include <MappedFile.hpp>
+#include <ScanResults.hpp>
 #include <ThreadPool.hpp>
+#include <tools.hpp>
+#include <analysis/BinaryIndex.hpp>
+#include <analysis/CallGraph.hpp>
+#include <analysis/StringXrefs.hpp>
+#include <analysis/Vtables.hpp>
+#include <binaries/ELF.hpp>
 #include <binaries/Mach-O.hpp>
 #include <binaries/PE.hpp>
 #include <fmt/format.h>
@@ -11,37 +23,79 @@
 using namespace geode;
 
 namespace scanpat {
-    Result<> Scanner::scan() {
-        GEODE_UNWRAP(this->readBinaryFile());
-        if (m_verbose) {
-            fmt::println("Read binary file: {} ({} bytes)", m_binaryFile, m_binaryData.size());
+    Result<> scanAll(std::string const& binaryFile, std::span<ScanJob const> jobs, bool verbose) {
+        GEODE_UNWRAP_INTO(auto binary, utils::MappedFile::open(binaryFile));
+        if (verbose) {
+            fmt::println("Mapped binary file: {} ({} bytes)", binaryFile, binary.size());
         }
 
-        GEODE_UNWRAP(this->readPatternsFile());
-        if (m_verbose) {
-            fmt::println("Target platform: {}", m_platformType);
+        auto binaryHash = utils::hashBytes(binary.data());
+
+        std::vector<std::unique_ptr<Scanner>> scanners;
+        scanners.reserve(jobs.size());
+        for (auto const& job : jobs) {
+            scanners.push_back(std::make_unique<Scanner>(
+                binary.data(), binaryFile, binaryHash, job.patternsFile, job.outputFile, verbose
+            ));
+        }
+
+        utils::ThreadPool pool{};
+
+        // every job streams its patterns file on a worker, the scan tasks it queues
+        // share the same pool, so parsing, binary loading and scanning all overlap
+        std::vector<Result<>> loaded(scanners.size(), Ok());
+        for (size_t i = 0; i < scanners.size(); ++i) {
+            pool.enqueue([&scanners, &loaded, &pool, i]() {
+                loaded[i] = scanners[i]->load(pool);
+            });
         }
+        pool.waitAll();
+
+        for (auto& res : loaded) {
+            GEODE_UNWRAP(std::move(res));
+        }
+
+        for (auto& scanner : scanners) {
+            GEODE_UNWRAP(scanner->finish(pool));
+        }
+
+        return Ok();
+    }
 
+    Result<> Scanner::prepareBinary() {
         switch (m_platformType) {
-            case Platform::M1: {
-                GEODE_UNWRAP_INTO(m_targetSegment, bin::mach::getSegment(m_binaryData, bin::mach::CPUType::ARM64));
+            case Platform::M1:
+            case Platform::IOS: {
+                GEODE_UNWRAP_INTO(m_image, bin::mach::getImage(m_binaryData, bin::mach::CPUType::ARM64));
+                GEODE_UNWRAP_INTO(auto text, bin::mach::getTextSection(m_image));
+                m_targetSegment = text.data;
+                m_baseCorrection = text.address;
                 break;
             }
             case Platform::IMAC: {
-                GEODE_UNWRAP_INTO(m_targetSegment, bin::mach::getSegment(m_binaryData, bin::mach::CPUType::X86_64));
+                GEODE_UNWRAP_INTO(m_image, bin::mach::getImage(m_binaryData, bin::mach::CPUType::X86_64));
+                GEODE_UNWRAP_INTO(auto text, bin::mach::getTextSection(m_image));
+                m_targetSegment = text.data;
+                m_baseCorrection = text.address;
                 break;
             }
             case Platform::WIN: {
                 GEODE_UNWRAP_INTO(auto virtSection, bin::pe::getSection(m_binaryData));
                 m_targetSegment = virtSection.data;
                 m_baseCorrection = virtSection.virtualAddress;
+                GEODE_UNWRAP_INTO(m_image, bin::pe::getImage(m_binaryData));
                 break;
             }
-            case Platform::IOS: {
-                GEODE_UNWRAP_INTO(m_targetSegment, bin::mach::getSegment(m_binaryData, bin::mach::CPUType::ARM64));
-                auto segmentStart = reinterpret_cast<uintptr_t>(m_targetSegment.data());
-                auto dataStart = reinterpret_cast<uintptr_t>(m_binaryData.data());
-                m_baseCorrection = segmentStart - dataStart;
+            case Platform::ANDROID32:
+            case Platform::ANDROID64: {
+                GEODE_UNWRAP_INTO(m_symbols, bin::elf::SymbolTable::build(m_binaryData));
+                GEODE_UNWRAP_INTO(m_image, bin::elf::getImage(m_binaryData, m_symbols));
+                auto text = m_image.findSection({}, ".text");
+                if (!text) {
+                    return Err("ELF file has no .text section");
+                }
+                m_targetSegment = text->data;
+                m_baseCorrection = text->address;
                 break;
             }
             default:
@@ -49,17 +103,32 @@ namespace scanpat {
         }
 
         if (m_verbose) {
-            fmt::println("Extracted target segment (start: {}, size: {})",
+            fmt::println("Extracted {} target segment (start: {}, size: {})",
+                m_platformType,
                 reinterpret_cast<uintptr_t>(m_targetSegment.data()) - reinterpret_cast<uintptr_t>(m_binaryData.data()),
                 m_targetSegment.size()
             );
         }
 
-        GEODE_UNWRAP(this->performScan());
-        GEODE_UNWRAP(this->saveResults());
+        m_stepSize = getScanStep(getArchitecture(m_platformType));
+
+        m_index = analysis::BinaryIndex::open(m_binaryFile, m_binaryHash, m_platformType);
+        return Ok();
+    }
+
+    Result<> Scanner::finish(utils::ThreadPool& pool) {
+        if (m_prepareError.has_value()) {
+            return Err(m_prepareError.value());
+        }
+
+        this->resolveThroughCallers();
+        m_index.save(m_verbose);
+        m_store.apply();
+        GEODE_UNWRAP(this->saveResults(pool));
 
         // summary
-        fmt::println("Scan complete: {} methods found, {} methods not found ({:.2f}%)",
+        fmt::println("{} scan complete: {} methods found, {} methods not found ({:.2f}%)",
+            m_platformType,
             m_successfulMethods.load(),
             m_failedMethods.load(),
             (static_cast<double>(m_successfulMethods.load()) /
@@ -69,153 +138,403 @@ namespace scanpat {
         return Ok();
     }
 
-    Result<> Scanner::readBinaryFile() {
-        std::ifstream file(m_binaryFile, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
-            return Err(fmt::format("Failed to open file: {}", m_binaryFile));
+    Result<> Scanner::load(utils::ThreadPool& pool) {
+        GEODE_UNWRAP_INTO(m_patternsData, utils::MappedFile::open(m_patternsFile));
+
+        // each class is queued the moment it is read. Only the resolution hints are converted,
+        // the rest of a method stays a slice of the mapped file and is copied verbatim into the results.
+        // genpat writes the platform first, which lets the binary load start right away;
+        // older JSON files have it last and buffer their classes until then
+        std::optional<std::string> storeError;
+        auto res = bromascan::readPatterns(
+            m_patternsData->data(),
+            m_classes,
+            [&](Platform platform) {
+                m_platformType = platform;
+                this->startPrepare(pool);
+            },
+            [&](bromascan::PatternClass& patternClass) {
+                if (storeError.has_value()) {
+                    return;
+                }
+
+                // offsets already in the file are replaced by the scan result
+                auto firstId = m_store.addClass(patternClass);
+                if (!firstId) {
+                    storeError = std::move(firstId).unwrapErr();
+                    return;
+                }
+                this->submitClass(pool, patternClass, firstId.unwrap());
+            }
+        );
+        if (!res) {
+            return Err(fmt::format("Failed to parse patterns file: {}: {}", m_patternsFile, res.unwrapErr()));
         }
 
-        auto size = file.tellg();
-        file.seekg(0, std::ios::beg);
-        m_binaryData.resize(size);
+        if (storeError.has_value()) {
+            return Err(storeError.value());
+        }
 
-        if (!file.read(reinterpret_cast<char*>(m_binaryData.data()), size)) {
-            return Err(fmt::format("Failed to read file: {}", m_binaryFile));
+        if (m_verbose) {
+            fmt::println("Loaded {} class bindings from patterns file: {} (platform: {})",
+                m_classes.size(),
+                m_patternsFile,
+                m_platformType
+            );
         }
 
         return Ok();
     }
 
-    Result<> Scanner::readPatternsFile() {
-        std::ifstream file(m_patternsFile);
-        if (!file.is_open()) {
-            return Err(fmt::format("Failed to open patterns file: {}", m_patternsFile));
-        }
+    void Scanner::startPrepare(utils::ThreadPool& pool) {
+        pool.enqueue([this, &pool]() {
+            auto res = this->prepareBinary();
 
-        auto jsonData = nlohmann::json::parse(file, nullptr, false);
-        if (jsonData.is_discarded()) {
-            return Err(fmt::format("Failed to parse patterns file: {}", m_patternsFile));
-        }
+            std::vector<std::pair<bromascan::PatternClass const*, uint32_t>> pending;
+            {
+                std::lock_guard lock(m_mutex);
+                m_prepared = true;
+                if (!res) {
+                    m_prepareError = std::move(res).unwrapErr();
+                }
+                pending = std::move(m_pendingClasses);
+            }
 
-        auto& classes = jsonData["classes"];
-        m_classBindings.reserve(classes.size());
+            if (m_prepareError.has_value()) {
+                return;
+            }
 
-        try {
-            for (auto& jsonClass : classes) {
-                m_classBindings.emplace_back(jsonClass.get<ClassBinding>());
+            for (auto [patternClass, firstId] : pending) {
+                pool.enqueue([this, patternClass, firstId]() {
+                    this->scanClass(*patternClass, firstId);
+                });
             }
-        } catch (std::exception& e) {
-            return Err(fmt::format("Failed to deserialize patterns file: {}: {}", m_patternsFile, e.what()));
-        }
+        });
+    }
 
-        if (m_verbose) {
-            fmt::println("Loaded {} class bindings from patterns file: {}",
-                m_classBindings.size(),
-                m_patternsFile
-            );
+    void Scanner::submitClass(utils::ThreadPool& pool, bromascan::PatternClass const& patternClass, uint32_t firstId) {
+        if (patternClass.binding.methods.empty()) {
+            return; // skip empty classes to save on thread
         }
 
-        auto platformStr = jsonData["platform"].get<std::string_view>();
-        if (platformStr == "Windows") {
-            m_platformType = Platform::WIN;
-        } else if (platformStr == "iMac") {
-            m_platformType = Platform::IMAC;
-        } else if (platformStr == "M1") {
-            m_platformType = Platform::M1;
-        } else if (platformStr == "iOS") {
-            m_platformType = Platform::IOS;
-        } else {
-            return Err(fmt::format("Unsupported platform in patterns file: {}", platformStr));
+        {
+            std::lock_guard lock(m_mutex);
+            if (!m_prepared) {
+                m_pendingClasses.emplace_back(&patternClass, firstId);
+                return;
+            }
+
+            if (m_prepareError.has_value()) {
+                return;
+            }
         }
 
-        return Ok();
+        pool.enqueue([this, &patternClass, firstId]() {
+            this->scanClass(patternClass, firstId);
+        });
     }
 
-    Result<> Scanner::performScan() {
-        utils::ThreadPool pool{};
+    analysis::StringXrefs const& Scanner::getStringXrefs() {
+        std::call_once(m_stringXrefsOnce, [this]() {
+            std::lock_guard lock(m_indexMutex); // the binary index isn't thread-safe
+            m_stringXrefs = m_index.getStringXrefs(m_image, getArchitecture(m_platformType));
+            if (m_verbose) {
+                fmt::println("Indexed {} string references ({} function starts)",
+                    m_stringXrefs.size(),
+                    m_image.functionStarts.size()
+                );
+            }
+        });
+        return m_stringXrefs;
+    }
 
-        size_t stepSize = 4; // default align to 4 bytes
-        if (m_platformType == Platform::WIN || m_platformType == Platform::IMAC) {
-            stepSize = 16; // align to 16 bytes for x86_64
+    analysis::VtableIndex const& Scanner::getVtables() {
+        std::call_once(m_vtablesOnce, [this]() {
+            std::lock_guard lock(m_indexMutex);
+            m_vtables = m_index.getVtables(m_image);
+            if (m_verbose) {
+                fmt::println("Indexed {} code pointers in constant data", m_vtables.size());
+            }
+        });
+        return m_vtables;
+    }
+
+    void Scanner::scanClass(bromascan::PatternClass const& patternClass, uint32_t firstId) {
+        auto const& methods = patternClass.binding.methods;
+        auto endId = firstId + static_cast<uint32_t>(methods.size());
+
+        // resolve the vtable anchor first, every other slot is then read straight from the vtable
+        std::optional<uint32_t> anchorId;
+        std::optional<analysis::Vtable> vtable;
+        if (auto anchor = std::ranges::find(methods, std::optional<int32_t>{0}, &MethodBinding::slot); anchor != methods.end()) {
+            anchorId = firstId + static_cast<uint32_t>(anchor - methods.begin());
+            this->scanMethod(anchorId.value());
+            if (m_store.getStatus(anchorId.value()) == bromascan::MethodStatus::Found) {
+                auto slots = this->getVtables().getSlots(m_store.getOffset(anchorId.value()));
+                if (slots.size() == 1) {
+                    vtable = analysis::VtableIndex::locate(m_image, slots.front().slot);
+                }
+            }
         }
 
-        for (auto& classBinding : m_classBindings) {
-            if (classBinding.methods.empty()) continue; // skip empty classes to save on thread
-            pool.enqueue([this, &classBinding, stepSize]() {
-                for (auto& methodBinding : classBinding.methods) {
-                    if (!methodBinding.pattern.has_value()) {
-                        continue; // skip methods without patterns
+        for (auto id = firstId; id < endId; ++id) {
+            if (id == anchorId) {
+                continue;
+            }
+
+            auto const& methodBinding = m_store.getMetadata(id);
+            if (vtable && methodBinding.slot.has_value()) {
+                auto address = vtable->read(m_image, methodBinding.slot.value());
+                if (address.has_value()) {
+                    m_store.resolve(id, address.value());
+                    ++m_successfulMethods;
+
+                    if (m_verbose) {
+                        fmt::println("Found method: {}::{} at address: 0x{:X} (vtable slot {})",
+                            patternClass.binding.name,
+                            methodBinding.method.name,
+                            address.value(),
+                            methodBinding.slot.value()
+                        );
                     }
+                    continue;
+                }
+            }
+
+            this->scanMethod(id);
+        }
+    }
 
-                    auto& patternStr = methodBinding.pattern.value();
-                    auto res = sinaps::find(
-                        m_targetSegment.data(),
-                        m_targetSegment.size(),
-                        patternStr,
-                        stepSize
+    void Scanner::scanMethod(uint32_t id) {
+        auto const& classBinding = m_store.getClass(id);
+        auto const& methodBinding = m_store.getMetadata(id);
+
+        if (methodBinding.symbol.has_value()) {
+            auto address = m_symbols.find(methodBinding.symbol.value());
+            if (address.has_value()) {
+                m_store.resolve(id, address.value());
+                ++m_successfulMethods;
+
+                if (m_verbose) {
+                    fmt::println("Found method: {}::{} at address: 0x{:X} (symbol)",
+                        classBinding.name,
+                        methodBinding.method.name,
+                        address.value()
                     );
+                }
+                return;
+            }
+        }
 
-                    if (res != sinaps::not_found) {
-                        auto address = res + m_baseCorrection;
-                        methodBinding.offset = address;
-                        ++m_successfulMethods;
-
-                        if (m_verbose) {
-                            fmt::println("Found method: {}::{} at address: 0x{:X}",
-                                classBinding.name,
-                                methodBinding.method.name,
-                                address
-                            );
-                        }
-                    } else {
-                        ++m_failedMethods;
-                        if (m_verbose) {
-                            fmt::println("Pattern not found for method: {}::{}",
-                                classBinding.name,
-                                methodBinding.method.name
-                            );
-                        }
-                    }
+        if (methodBinding.pattern.has_value()) {
+            intptr_t res;
+            if (auto pattern = m_store.getPattern(id); !pattern.empty()) {
+                // patterns are parsed once when they are loaded, skip parsing the text form
+                thread_local std::vector<sinaps::token_t> tokens;
+                bromascan::toTokens(pattern, tokens);
+                res = sinaps::find(m_targetSegment.data(), m_targetSegment.size(), tokens, m_stepSize);
+            } else {
+                res = sinaps::find(
+                    m_targetSegment.data(),
+                    m_targetSegment.size(),
+                    methodBinding.pattern.value(),
+                    m_stepSize
+                );
+            }
+
+            if (res != sinaps::not_found) {
+                // the pattern may start a few instructions into the function
+                auto address = res + m_baseCorrection - methodBinding.start.value_or(0);
+                m_store.resolve(id, address);
+                ++m_successfulMethods;
+
+                if (m_verbose) {
+                    fmt::println("Found method: {}::{} at address: 0x{:X}",
+                        classBinding.name,
+                        methodBinding.method.name,
+                        address
+                    );
                 }
-            });
+                return;
+            }
         }
 
-        pool.waitAll();
-        return Ok();
-    }
+        // string anchors need the string reference index, so they only back up a pattern that broke
+        if (methodBinding.anchor.has_value()) {
+            auto address = this->getStringXrefs().resolve(m_image, methodBinding.anchor.value());
+            if (address.has_value()) {
+                m_store.resolve(id, address.value());
+                ++m_successfulMethods;
+
+                if (m_verbose) {
+                    fmt::println("Found method: {}::{} at address: 0x{:X} (string anchor)",
+                        classBinding.name,
+                        methodBinding.method.name,
+                        address.value()
+                    );
+                }
+                return;
+            }
+        }
 
-    Result<> Scanner::saveResults() {
-        // remove all patterns and missing offsets from the results
-        std::vector<ClassBinding> filteredBindings;
-        filteredBindings.reserve(m_classBindings.size());
+        // methods too small for a pattern of their own are the target of a call next to a unique one
+        if (methodBinding.callSite.has_value()) {
+            auto const& callSite = methodBinding.callSite.value();
+            intptr_t res;
+            if (auto pattern = m_store.getCallSitePattern(id); !pattern.empty()) {
+                thread_local std::vector<sinaps::token_t> tokens;
+                bromascan::toTokens(pattern, tokens);
+                res = sinaps::find(m_targetSegment.data(), m_targetSegment.size(), tokens, m_stepSize);
+            } else {
+                res = sinaps::find(m_targetSegment.data(), m_targetSegment.size(), callSite.pattern, m_stepSize);
+            }
+            auto address = res == sinaps::not_found ? std::nullopt : analysis::decodeCall(
+                m_targetSegment,
+                m_baseCorrection,
+                static_cast<size_t>(res) + callSite.offset,
+                getArchitecture(m_platformType)
+            );
 
-        for (auto& classBinding : m_classBindings) {
-            ClassBinding filteredClass;
-            filteredClass.methods.reserve(classBinding.methods.size());
-            filteredClass.name = std::move(classBinding.name);
+            if (address.has_value()) {
+                m_store.resolve(id, address.value());
+                ++m_successfulMethods;
 
-            for (auto& methodBinding : classBinding.methods) {
-                if (methodBinding.offset.has_value()) {
-                    methodBinding.pattern = std::nullopt; // remove pattern to reduce output size
-                    filteredClass.methods.emplace_back(std::move(methodBinding));
+                if (m_verbose) {
+                    fmt::println("Found method: {}::{} at address: 0x{:X} (call site)",
+                        classBinding.name,
+                        methodBinding.method.name,
+                        address.value()
+                    );
                 }
+                return;
+            }
+        }
+
+        if (methodBinding.pattern.has_value()) {
+            m_store.fail(id);
+            ++m_failedMethods;
+            if (m_verbose) {
+                fmt::println("Pattern not found for method: {}::{}",
+                    classBinding.name,
+                    methodBinding.method.name
+                );
             }
+        } else if (!methodBinding.caller.has_value()) {
+            // caller relations are resolved after all patterns are done
+            m_store.fail(id);
+            ++m_failedMethods;
+            if (m_verbose) {
+                fmt::println("Method could not be resolved without a pattern: {}::{}",
+                    classBinding.name,
+                    methodBinding.method.name
+                );
+            }
+        }
+    }
 
-            if (!filteredClass.methods.empty()) {
-                filteredBindings.emplace_back(std::move(filteredClass));
+    void Scanner::resolveThroughCallers() {
+        std::unordered_map<std::string_view, uintptr_t> resolvedPatterns;
+        bool hasCallers = false;
+        for (uint32_t id = 0; id < m_store.size(); ++id) {
+            auto const& methodBinding = m_store.getMetadata(id);
+            if (methodBinding.pattern.has_value() && m_store.getStatus(id) == bromascan::MethodStatus::Found) {
+                resolvedPatterns.emplace(methodBinding.pattern.value(), m_store.getOffset(id));
             }
+            hasCallers |= methodBinding.caller.has_value();
         }
 
-        nlohmann::json jsonData;
-        jsonData["platform"] = format_as(m_platformType);
-        jsonData["classes"] = filteredBindings;
+        if (!hasCallers) {
+            return;
+        }
+
+        auto graph = m_index.getCallGraph(
+            m_targetSegment,
+            m_baseCorrection,
+            getArchitecture(m_platformType)
+        );
+
+        if (m_verbose) {
+            fmt::println("Built call graph: {} direct calls", graph.size());
+        }
+
+        for (uint32_t id = 0; id < m_store.size(); ++id) {
+            auto const& methodBinding = m_store.getMetadata(id);
+            if (!methodBinding.caller.has_value()) {
+                continue;
+            }
+
+            std::optional<uintptr_t> address;
+            auto const& caller = methodBinding.caller.value();
+            if (auto it = resolvedPatterns.find(caller.pattern); it != resolvedPatterns.end()) {
+                address = graph.getCallee(it->second, caller.index);
+            }
+
+            if (address.has_value()) {
+                m_store.resolve(id, address.value());
+                ++m_successfulMethods;
+
+                if (m_verbose) {
+                    fmt::println("Found method: {}::{} at address: 0x{:X} (call #{} of caller)",
+                        m_store.getClass(id).name,
+                        methodBinding.method.name,
+                        address.value(),
+                        caller.index
+                    );
+                }
+            } else {
+                m_store.fail(id);
+                ++m_failedMethods;
+                if (m_verbose) {
+                    fmt::println("Caller not resolved for method: {}::{}",
+                        m_store.getClass(id).name,
+                        methodBinding.method.name
+                    );
+                }
+            }
+        }
+    }
+
+    Result<> Scanner::saveResults(utils::ThreadPool& pool) {
+        std::string out;
+        if (m_outputFile.ends_with(".bsres")) {
+            std::vector<bromascan::ResolvedMethod> methods;
+            for (auto const& classBinding : m_classes | std::views::transform(&bromascan::PatternClass::binding)) {
+                for (auto const& methodBinding : classBinding.methods) {
+                    if (methodBinding.offset.has_value()) {
+                        methods.emplace_back(
+                            bromascan::getMethodId(classBinding.name, methodBinding.method),
+                            methodBinding.offset.value()
+                        );
+                    }
+                }
+            }
+
+            auto bytes = bromascan::writeCompactResults(m_platformType, std::move(methods));
+            out.assign(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+        } else {
+            // the pass-through slices of the patterns file already carry the `dump(2)` indentation,
+            // every class is formatted into its own buffer on the pool and concatenated in order
+            std::vector<std::string> buffers(m_classes.size());
+            for (size_t i = 0; i < m_classes.size(); ++i) {
+                pool.enqueue([this, &buffers, i]() {
+                    buffers[i] = bromascan::PatternsJsonWriter::formatClass(m_classes[i], true);
+                });
+            }
+            pool.waitAll();
+
+            bromascan::PatternsJsonWriter writer(m_platformType, true);
+            for (auto const& buffer : buffers) {
+                writer.append(buffer);
+            }
+            out = writer.finish();
+        }
 
-        std::ofstream file(m_outputFile);
+        std::ofstream file(m_outputFile, std::ios::binary);
         if (!file.is_open()) {
             return Err(fmt::format("Failed to open output file: {}", m_outputFile));
         }
 
-        file << jsonData.dump(2);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
 
         if (m_verbose) {
             fmt::println("Saved scan results to output file: {}", m_outputFile);
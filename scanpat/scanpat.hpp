@@ -1,45 +1,102 @@
 #pragma once
 #include <atomic>
+#include <deque>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <bromascan.hpp>
+#include <BindingStore.hpp>
+#include <MappedFile.hpp>
+#include <PatternFile.hpp>
+#include <analysis/BinaryIndex.hpp>
+#include <analysis/StringXrefs.hpp>
+#include <analysis/Vtables.hpp>
+#include <binaries/ELF.hpp>
+#include <binaries/Image.hpp>
 #include <Geode/Result.hpp>
 
+namespace utils {
+    class ThreadPool;
+}
+
 namespace scanpat {
+    /// One patterns file scanned against the binary, results go to `outputFile`
+    struct ScanJob {
+        std::string patternsFile;
+        std::string outputFile;
+    };
+
+    /// Maps `binaryFile` once and scans every job against it on a shared thread pool.
+    /// Each job picks its own slice of a fat Mach-O, so M1 and iMac can run together.
+    geode::Result<> scanAll(std::string const& binaryFile, std::span<ScanJob const> jobs, bool verbose);
+
     class Scanner {
     public:
         Scanner(
+            std::span<uint8_t const> binaryData,
             std::string binaryFile,
+            uint64_t binaryHash,
             std::string patternsFile,
             std::string outputFile,
             bool verbose
-        ) : m_binaryFile(std::move(binaryFile)),
+        ) : m_binaryData(binaryData), m_binaryFile(std::move(binaryFile)), m_binaryHash(binaryHash),
             m_patternsFile(std::move(patternsFile)), m_outputFile(std::move(outputFile)),
             m_verbose(verbose) {}
 
-        geode::Result<> scan();
+        /// Streams the patterns file (JSON or pattern database) and queues a scan task on `pool` for each class as soon as it is parsed.
+        /// The binary is prepared on the pool in parallel once the platform is known,
+        /// it must stay mapped until the pool is drained.
+        geode::Result<> load(utils::ThreadPool& pool);
+        /// Runs the passes that depend on every pattern result and writes the output file
+        geode::Result<> finish(utils::ThreadPool& pool);
 
     private:
-        geode::Result<> readBinaryFile();
-        geode::Result<> readPatternsFile();
-        geode::Result<> performScan();
-        geode::Result<> saveResults();
+        geode::Result<> prepareBinary();
+        void startPrepare(utils::ThreadPool& pool);
+        void submitClass(utils::ThreadPool& pool, bromascan::PatternClass const& patternClass, uint32_t firstId);
+        void scanClass(bromascan::PatternClass const& patternClass, uint32_t firstId);
+        analysis::StringXrefs const& getStringXrefs();
+        analysis::VtableIndex const& getVtables();
+        void scanMethod(uint32_t id);
+        void resolveThroughCallers();
+        geode::Result<> saveResults(utils::ThreadPool& pool);
 
     private:
-        std::vector<uint8_t> m_binaryData;
-        std::vector<ClassBinding> m_classBindings;
+        std::span<uint8_t const> m_binaryData;
+        std::optional<utils::MappedFile> m_patternsData; // backs the raw metadata slices
+        std::deque<bromascan::PatternClass> m_classes; // stable addresses while the parser keeps appending
+        bromascan::BindingStore m_store; // what the scan loop reads and writes, indexed by method ID
         std::span<uint8_t const> m_targetSegment;
-        std::mutex m_mutex;
+        bin::Image m_image;
+        analysis::BinaryIndex m_index;
+        analysis::StringXrefs m_stringXrefs;
+        analysis::VtableIndex m_vtables;
+        bin::elf::SymbolTable m_symbols;
         intptr_t m_baseCorrection = 0;
+        size_t m_stepSize = 4;
         Platform m_platformType = Platform::WIN;
 
+        // classes parsed before the binary is prepared wait here
+        std::mutex m_mutex;
+        std::vector<std::pair<bromascan::PatternClass const*, uint32_t>> m_pendingClasses;
+        bool m_prepared = false;
+        std::optional<std::string> m_prepareError;
+
+        // indexes are only built once a class actually needs them
+        std::mutex m_indexMutex;
+        std::once_flag m_stringXrefsOnce;
+        std::once_flag m_vtablesOnce;
+
         std::atomic<size_t> m_successfulMethods = 0;
         std::atomic<size_t> m_failedMethods = 0;
 
         std::string m_binaryFile;
+        uint64_t m_binaryHash;
         std::string m_patternsFile;
         std::string m_outputFile;
         bool m_verbose;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace utils {
+    /// Bump allocator for many small objects that all live as long as the arena.
+    /// Nothing is freed individually and it isn't thread-safe.
+    class Arena {
+    public:
+        explicit Arena(size_t chunkSize = 64 * 1024) : m_chunkSize(chunkSize) {}
+
+        Arena(Arena const&) = delete;
+        Arena& operator=(Arena const&) = delete;
+        Arena(Arena&&) = default;
+        Arena& operator=(Arena&&) = default;
+
+        void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            auto padding = (0 - reinterpret_cast<uintptr_t>(m_current)) & (alignment - 1);
+            if (!m_current || padding + size > m_remaining) {
+                // oversized requests get a chunk of their own
+                auto chunkSize = std::max(m_chunkSize, size + alignment);
+                m_current = m_chunks.emplace_back(std::make_unique<std::byte[]>(chunkSize)).get();
+                m_remaining = chunkSize;
+                padding = (0 - reinterpret_cast<uintptr_t>(m_current)) & (alignment - 1);
+            }
+
+            auto result = m_current + padding;
+            m_current = result + size;
+            m_remaining -= padding + size;
+            return result;
+        }
+
+    private:
+        std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+        std::byte* m_current = nullptr;
+        size_t m_remaining = 0;
+        size_t m_chunkSize;
+    };
+}
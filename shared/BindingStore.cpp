@@ -0,0 +1,74 @@
+#include "BindingStore.hpp"
+
+#include <cstring>
+
+namespace bromascan {
+    geode::Result<uint32_t> BindingStore::addClass(PatternClass& patternClass) {
+        auto& methods = patternClass.binding.methods;
+        auto first = m_size;
+        auto size = m_size + methods.size();
+
+        constexpr size_t capacity = Column<uint64_t>::chunkSize * Column<uint64_t>::maxChunks;
+        if (size > capacity) {
+            return geode::Err("Too many methods to scan at once");
+        }
+
+        m_patterns.grow(size);
+        m_callSitePatterns.grow(size);
+        m_offsets.grow(size);
+        m_statuses.grow(size);
+        m_metadata.grow(size);
+        m_classes.grow(size);
+
+        for (size_t i = 0; i < methods.size(); ++i) {
+            auto id = first + i;
+            auto& method = methods[i];
+
+            // databases come pre-tokenized, text that doesn't parse falls back to sinaps' own parser
+            std::span<MaskedByte const> pattern = patternClass.getPatternBytes(i);
+            if (pattern.empty() && method.pattern.has_value()) {
+                pattern = this->parse(method.pattern.value());
+            }
+
+            std::span<MaskedByte const> callSite = patternClass.getCallSiteBytes(i);
+            if (callSite.empty() && method.callSite.has_value()) {
+                callSite = this->parse(method.callSite->pattern);
+            }
+
+            m_patterns[id] = pattern;
+            m_callSitePatterns[id] = callSite;
+            m_offsets[id] = 0;
+            m_statuses[id] = MethodStatus::Pending;
+            m_metadata[id] = &method;
+            m_classes[id] = &patternClass.binding;
+        }
+
+        m_size = size;
+        return geode::Ok(static_cast<uint32_t>(first));
+    }
+
+    std::span<MaskedByte const> BindingStore::parse(std::string_view pattern) {
+        auto bytes = parsePattern(pattern);
+        if (!bytes) {
+            return {};
+        }
+
+        auto& parsed = bytes.unwrap();
+        auto storage = static_cast<MaskedByte*>(
+            m_patternBytes.allocate(parsed.size() * sizeof(MaskedByte), alignof(MaskedByte))
+        );
+        std::memcpy(storage, parsed.data(), parsed.size() * sizeof(MaskedByte));
+        return {storage, parsed.size()};
+    }
+
+    void BindingStore::apply() {
+        for (size_t id = 0; id < m_size; ++id) {
+            auto& method = *m_metadata[id];
+            if (m_statuses[id] == MethodStatus::Found) {
+                method.offset = static_cast<uintptr_t>(m_offsets[id]);
+            } else {
+                method.offset.reset();
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <Geode/Result.hpp>
+
+#include "Arena.hpp"
+#include "bromascan.hpp"
+#include "PatternFile.hpp"
+
+namespace bromascan {
+    enum class MethodStatus : uint8_t {
+        Pending,
+        Found,
+        NotFound
+    };
+
+    /// Scan-time state of every method in flat columns indexed by method ID (the order methods were added).
+    /// The scan loop only reads patterns and writes offsets and statuses, names and the other hints stay
+    /// in a side table of `MethodBinding`s. Columns are chunked, so adding methods never moves existing
+    /// ones: one thread may keep adding classes while others work on methods that were already added.
+    class BindingStore {
+    public:
+        /// Adds the methods of a class and returns the ID of the first one.
+        /// Text patterns are parsed into masked bytes once here.
+        geode::Result<uint32_t> addClass(PatternClass& patternClass);
+
+        [[nodiscard]] size_t size() const { return m_size; }
+
+        /// Masked bytes of the method's pattern, empty if it has none
+        [[nodiscard]] std::span<MaskedByte const> getPattern(uint32_t id) const { return m_patterns[id]; }
+        /// Masked bytes of the method's call site pattern, empty if it has none
+        [[nodiscard]] std::span<MaskedByte const> getCallSitePattern(uint32_t id) const { return m_callSitePatterns[id]; }
+        [[nodiscard]] MethodBinding const& getMetadata(uint32_t id) const { return *m_metadata[id]; }
+        [[nodiscard]] ClassBinding const& getClass(uint32_t id) const { return *m_classes[id]; }
+        [[nodiscard]] uint64_t getOffset(uint32_t id) const { return m_offsets[id]; }
+        [[nodiscard]] MethodStatus getStatus(uint32_t id) const { return m_statuses[id]; }
+
+        void resolve(uint32_t id, uint64_t offset) {
+            m_offsets[id] = offset;
+            m_statuses[id] = MethodStatus::Found;
+        }
+        void fail(uint32_t id) { m_statuses[id] = MethodStatus::NotFound; }
+
+        /// Writes the resolved offsets back to the bindings
+        void apply();
+
+    private:
+        template <typename T>
+        class Column {
+        public:
+            static constexpr size_t chunkSize = 16384;
+            static constexpr size_t maxChunks = 4096;
+
+            T& operator[](size_t index) const { return m_chunks[index / chunkSize][index % chunkSize]; }
+
+            void grow(size_t size) {
+                for (size_t chunk = m_chunkCount; chunk * chunkSize < size; ++chunk) {
+                    m_chunks[chunk] = std::make_unique<T[]>(chunkSize);
+                    m_chunkCount = chunk + 1;
+                }
+            }
+
+        private:
+            // fixed table, so looking up a chunk never races with adding one
+            std::unique_ptr<std::unique_ptr<T[]>[]> m_chunks = std::make_unique<std::unique_ptr<T[]>[]>(maxChunks);
+            size_t m_chunkCount = 0;
+        };
+
+        std::span<MaskedByte const> parse(std::string_view pattern);
+
+        Column<std::span<MaskedByte const>> m_patterns;
+        Column<std::span<MaskedByte const>> m_callSitePatterns;
+        Column<uint64_t> m_offsets;
+        Column<MethodStatus> m_statuses;
+        Column<MethodBinding*> m_metadata;
+        Column<ClassBinding const*> m_classes;
+        utils::Arena m_patternBytes; // patterns parsed from text
+        size_t m_size = 0;
+    };
+}
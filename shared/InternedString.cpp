@@ -0,0 +1,61 @@
+#include "InternedString.hpp"
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+#include "Arena.hpp"
+
+namespace utils {
+    namespace {
+        struct StringShard {
+            std::mutex mutex;
+            Arena arena;
+            std::unordered_set<std::string_view> entries; // views of the arena text
+        };
+
+        // every string maps to one independently locked shard, so threads interning
+        // different strings rarely wait on each other
+        constexpr size_t shardBits = 6;
+
+        StringShard& getShard(size_t hash) {
+            // leaked on purpose, handles in static objects may outlive any destruction order
+            static auto shards = new std::array<StringShard, size_t{1} << shardBits>();
+
+            // the top bits, the sets inside pick their buckets from the low ones
+            return (*shards)[hash >> (sizeof(size_t) * 8 - shardBits)];
+        }
+
+        struct EmptyEntry {
+            uint32_t size = 0;
+            char text = '\0';
+        };
+    }
+
+    char const* InternedString::getEmpty() {
+        static constexpr EmptyEntry empty{};
+        return &empty.text;
+    }
+
+    char const* InternedString::intern(std::string_view str) {
+        if (str.empty()) {
+            return getEmpty();
+        }
+
+        auto& shard = getShard(std::hash<std::string_view>{}(str));
+        std::lock_guard lock(shard.mutex);
+        if (auto it = shard.entries.find(str); it != shard.entries.end()) {
+            return it->data();
+        }
+
+        auto size = static_cast<uint32_t>(str.size());
+        auto entry = static_cast<char*>(shard.arena.allocate(sizeof(size) + str.size() + 1, alignof(uint32_t)));
+        std::memcpy(entry, &size, sizeof(size));
+        std::memcpy(entry + sizeof(size), str.data(), str.size());
+        entry[sizeof(size) + str.size()] = '\0';
+
+        shard.entries.emplace(entry + sizeof(size), str.size());
+        return entry + sizeof(size);
+    }
+}
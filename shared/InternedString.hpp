@@ -0,0 +1,48 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace utils {
+    /// Handle to a string stored once in a process-wide pool. Copying is a pointer copy and two handles
+    /// are equal only if they point to the same entry. Entries are never freed.
+    class InternedString {
+    public:
+        InternedString() : m_data(getEmpty()) {}
+        InternedString(std::string_view str) : m_data(intern(str)) {}
+        InternedString(std::string const& str) : m_data(intern(str)) {}
+        InternedString(char const* str) : m_data(intern(str)) {}
+
+        [[nodiscard]] std::string_view view() const { return {m_data, size()}; }
+        operator std::string_view() const { return this->view(); }
+
+        /// Entries are null-terminated
+        [[nodiscard]] char const* c_str() const { return m_data; }
+        [[nodiscard]] char const* data() const { return m_data; }
+        [[nodiscard]] bool empty() const { return this->size() == 0; }
+        [[nodiscard]] size_t size() const {
+            uint32_t size;
+            std::memcpy(&size, m_data - sizeof(size), sizeof(size));
+            return size;
+        }
+
+        friend bool operator==(InternedString a, InternedString b) { return a.m_data == b.m_data; }
+
+        template <typename T>
+            requires std::convertible_to<T const&, std::string_view> && (!std::same_as<T, InternedString>)
+        friend bool operator==(InternedString a, T const& b) {
+            return a.view() == std::string_view(b);
+        }
+
+        friend std::string_view format_as(InternedString str) { return str.view(); }
+
+    private:
+        static char const* getEmpty();
+        static char const* intern(std::string_view str);
+
+        char const* m_data; // text of the entry, its size is stored right before it
+    };
+}
@@ -0,0 +1,294 @@
+#include "JsonReader.hpp"
+
+#include <fmt/format.h>
+
+namespace utils {
+    std::string JsonReader::error(std::string_view message) const {
+        return fmt::format("JSON error at offset {}: {}", m_pos, message);
+    }
+
+    void JsonReader::skipWhitespace() {
+        while (m_pos < m_data.size()) {
+            char c = m_data[m_pos];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                break;
+            }
+            ++m_pos;
+        }
+    }
+
+    geode::Result<> JsonReader::expect(char c) {
+        this->skipWhitespace();
+        if (m_pos >= m_data.size() || m_data[m_pos] != c) {
+            return geode::Err(this->error(fmt::format("expected '{}'", c)));
+        }
+        ++m_pos;
+        return geode::Ok();
+    }
+
+    geode::Result<> JsonReader::beginObject() {
+        GEODE_UNWRAP(this->expect('{'));
+        m_hasElements.push_back(false);
+        return geode::Ok();
+    }
+
+    geode::Result<std::optional<std::string_view>> JsonReader::nextKey() {
+        if (m_hasElements.empty()) {
+            return geode::Err(this->error("not inside an object"));
+        }
+
+        this->skipWhitespace();
+        if (m_pos < m_data.size() && m_data[m_pos] == '}') {
+            ++m_pos;
+            m_hasElements.pop_back();
+            return geode::Ok(std::nullopt);
+        }
+
+        if (m_hasElements.back()) {
+            GEODE_UNWRAP(this->expect(','));
+            this->skipWhitespace();
+        }
+        m_hasElements.back() = true;
+
+        m_keyStart = m_pos;
+        GEODE_UNWRAP_INTO(auto key, this->readRawString());
+        GEODE_UNWRAP(this->expect(':'));
+        return geode::Ok(key);
+    }
+
+    geode::Result<> JsonReader::beginArray() {
+        GEODE_UNWRAP(this->expect('['));
+        m_hasElements.push_back(false);
+        return geode::Ok();
+    }
+
+    geode::Result<bool> JsonReader::nextElement() {
+        if (m_hasElements.empty()) {
+            return geode::Err(this->error("not inside an array"));
+        }
+
+        this->skipWhitespace();
+        if (m_pos < m_data.size() && m_data[m_pos] == ']') {
+            ++m_pos;
+            m_hasElements.pop_back();
+            return geode::Ok(false);
+        }
+
+        if (m_hasElements.back()) {
+            GEODE_UNWRAP(this->expect(','));
+        }
+        m_hasElements.back() = true;
+        return geode::Ok(true);
+    }
+
+    geode::Result<std::string_view> JsonReader::readRawString() {
+        GEODE_UNWRAP(this->expect('"'));
+        auto start = m_pos;
+        while (m_pos < m_data.size() && m_data[m_pos] != '"') {
+            m_pos += m_data[m_pos] == '\\' ? 2 : 1;
+        }
+
+        if (m_pos >= m_data.size()) {
+            return geode::Err(this->error("unterminated string"));
+        }
+
+        return geode::Ok(m_data.substr(start, m_pos++ - start));
+    }
+
+    static void appendUtf8(std::string& out, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            out += static_cast<char>(codepoint);
+        } else if (codepoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    static std::optional<uint32_t> parseHex4(std::string_view raw, size_t pos) {
+        if (pos + 4 > raw.size()) {
+            return std::nullopt;
+        }
+
+        uint32_t value = 0;
+        for (size_t i = pos; i < pos + 4; ++i) {
+            char c = raw[i];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return std::nullopt;
+        }
+        return value;
+    }
+
+    geode::Result<std::string> JsonReader::readString() {
+        GEODE_UNWRAP_INTO(auto raw, this->readRawString());
+
+        std::string out;
+        out.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '\\') {
+                out += raw[i];
+                continue;
+            }
+
+            switch (char c = raw[++i]) {
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    auto codepoint = parseHex4(raw, i + 1);
+                    if (!codepoint) {
+                        return geode::Err(this->error("invalid unicode escape"));
+                    }
+                    i += 4;
+
+                    // surrogate pair
+                    if (*codepoint >= 0xD800 && *codepoint < 0xDC00 && raw.substr(i + 1, 2) == "\\u") {
+                        auto low = parseHex4(raw, i + 3);
+                        if (low && *low >= 0xDC00 && *low < 0xE000) {
+                            codepoint = 0x10000 + ((*codepoint - 0xD800) << 10) + (*low - 0xDC00);
+                            i += 6;
+                        }
+                    }
+
+                    appendUtf8(out, *codepoint);
+                    break;
+                }
+                default: out += c; break; // '"', '\\' and '/'
+            }
+        }
+
+        return geode::Ok(std::move(out));
+    }
+
+    geode::Result<int64_t> JsonReader::readInteger() {
+        this->skipWhitespace();
+        auto start = m_pos;
+        GEODE_UNWRAP(this->skipNumber());
+
+        auto text = m_data.substr(start, m_pos - start);
+        bool negative = text.starts_with('-');
+        int64_t value = 0;
+        for (char c : text.substr(negative ? 1 : 0)) {
+            if (c < '0' || c > '9') {
+                return geode::Err(this->error("expected an integer"));
+            }
+            value = value * 10 + (c - '0');
+        }
+
+        return geode::Ok(negative ? -value : value);
+    }
+
+    geode::Result<bool> JsonReader::readBool() {
+        this->skipWhitespace();
+        if (m_data.substr(m_pos, 4) == "true") {
+            m_pos += 4;
+            return geode::Ok(true);
+        }
+
+        GEODE_UNWRAP(this->skipLiteral("false"));
+        return geode::Ok(false);
+    }
+
+    char JsonReader::peek() {
+        this->skipWhitespace();
+        return m_pos < m_data.size() ? m_data[m_pos] : '\0';
+    }
+
+    bool JsonReader::skipNull() {
+        this->skipWhitespace();
+        if (m_data.substr(m_pos, 4) == "null") {
+            m_pos += 4;
+            return true;
+        }
+        return false;
+    }
+
+    geode::Result<> JsonReader::skipLiteral(std::string_view literal) {
+        if (m_data.substr(m_pos, literal.size()) != literal) {
+            return geode::Err(this->error("unexpected token"));
+        }
+        m_pos += literal.size();
+        return geode::Ok();
+    }
+
+    geode::Result<> JsonReader::skipNumber() {
+        auto start = m_pos;
+        while (m_pos < m_data.size()) {
+            char c = m_data[m_pos];
+            bool numeric = (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+            if (!numeric) {
+                break;
+            }
+            ++m_pos;
+        }
+
+        if (m_pos == start) {
+            return geode::Err(this->error("expected a value"));
+        }
+        return geode::Ok();
+    }
+
+    geode::Result<std::string_view> JsonReader::skipValue() {
+        this->skipWhitespace();
+        if (m_pos >= m_data.size()) {
+            return geode::Err(this->error("unexpected end of input"));
+        }
+
+        auto start = m_pos;
+        switch (m_data[m_pos]) {
+            case '"': {
+                GEODE_UNWRAP(this->readRawString());
+                break;
+            }
+            case '{': {
+                GEODE_UNWRAP(this->beginObject());
+                while (true) {
+                    GEODE_UNWRAP_INTO(auto key, this->nextKey());
+                    if (!key) break;
+                    GEODE_UNWRAP(this->skipValue());
+                }
+                break;
+            }
+            case '[': {
+                GEODE_UNWRAP(this->beginArray());
+                while (true) {
+                    GEODE_UNWRAP_INTO(bool hasNext, this->nextElement());
+                    if (!hasNext) break;
+                    GEODE_UNWRAP(this->skipValue());
+                }
+                break;
+            }
+            case 't': {
+                GEODE_UNWRAP(this->skipLiteral("true"));
+                break;
+            }
+            case 'f': {
+                GEODE_UNWRAP(this->skipLiteral("false"));
+                break;
+            }
+            case 'n': {
+                GEODE_UNWRAP(this->skipLiteral("null"));
+                break;
+            }
+            default: {
+                GEODE_UNWRAP(this->skipNumber());
+                break;
+            }
+        }
+
+        return geode::Ok(m_data.substr(start, m_pos - start));
+    }
+}
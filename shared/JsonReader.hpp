@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Geode/Result.hpp>
+
+namespace utils {
+    /// Pull reader over an in-memory JSON document.
+    /// Values can be skipped and handed out as exact slices of the source text instead of being converted,
+    /// so callers only pay for the fields they actually use.
+    class JsonReader {
+    public:
+        explicit JsonReader(std::string_view data) : m_data(data) {}
+
+        geode::Result<> beginObject();
+        /// Reads the next key of the current object, returns nullopt once the closing brace is consumed.
+        /// Keys are returned raw, escape sequences are not decoded.
+        geode::Result<std::optional<std::string_view>> nextKey();
+
+        geode::Result<> beginArray();
+        /// Moves to the next array element, returns false once the closing bracket is consumed
+        geode::Result<bool> nextElement();
+
+        geode::Result<std::string> readString();
+        geode::Result<int64_t> readInteger();
+        geode::Result<bool> readBool();
+        /// Returns the first character of the next value without consuming it, or 0 at the end of the input
+        char peek();
+        /// Consumes a `null` if it is the next value
+        bool skipNull();
+        /// Skips over the next value and returns its source text
+        geode::Result<std::string_view> skipValue();
+
+        /// Offset of the opening quote of the last key returned by `nextKey`
+        [[nodiscard]] size_t getKeyStart() const { return m_keyStart; }
+        [[nodiscard]] size_t getPosition() const { return m_pos; }
+        [[nodiscard]] std::string_view getSlice(size_t start) const { return m_data.substr(start, m_pos - start); }
+
+    private:
+        void skipWhitespace();
+        geode::Result<> expect(char c);
+        geode::Result<std::string_view> readRawString();
+        geode::Result<> skipLiteral(std::string_view literal);
+        geode::Result<> skipNumber();
+        std::string error(std::string_view message) const;
+
+        std::string_view m_data;
+        size_t m_pos = 0;
+        size_t m_keyStart = 0;
+        std::vector<bool> m_hasElements; // per open container, whether a comma is due before the next item
+    };
+}
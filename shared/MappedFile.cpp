@@ -0,0 +1,128 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+#include <fmt/format.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+#ifdef _WIN32
+    geode::Result<MappedFile> MappedFile::open(std::string const& path) {
+        MappedFile file;
+        file.m_file = CreateFileA(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+        );
+        if (file.m_file == INVALID_HANDLE_VALUE) {
+            file.m_file = nullptr;
+            return geode::Err(fmt::format("Failed to open file: {}", path));
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file.m_file, &size)) {
+            return geode::Err(fmt::format("Failed to read file: {}", path));
+        }
+
+        file.m_size = static_cast<size_t>(size.QuadPart);
+        if (file.m_size == 0) {
+            return geode::Ok(std::move(file));
+        }
+
+        file.m_mapping = CreateFileMappingA(file.m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!file.m_mapping) {
+            return geode::Err(fmt::format("Failed to map file: {}", path));
+        }
+
+        file.m_data = static_cast<uint8_t const*>(MapViewOfFile(file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!file.m_data) {
+            return geode::Err(fmt::format("Failed to map file: {}", path));
+        }
+
+        return geode::Ok(std::move(file));
+    }
+
+    void MappedFile::close() {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file) CloseHandle(m_file);
+        m_data = nullptr;
+        m_mapping = nullptr;
+        m_file = nullptr;
+        m_size = 0;
+    }
+#else
+    geode::Result<MappedFile> MappedFile::open(std::string const& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return geode::Err(fmt::format("Failed to open file: {}", path));
+        }
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return geode::Err(fmt::format("Failed to read file: {}", path));
+        }
+
+        MappedFile file;
+        file.m_size = static_cast<size_t>(info.st_size);
+        if (file.m_size == 0) {
+            ::close(fd);
+            return geode::Ok(std::move(file));
+        }
+
+        // the mapping keeps its own reference to the file, the descriptor isn't needed past this
+        void* data = mmap(nullptr, file.m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            file.m_size = 0;
+            return geode::Err(fmt::format("Failed to map file: {}", path));
+        }
+
+        file.m_data = static_cast<uint8_t const*>(data);
+        return geode::Ok(std::move(file));
+    }
+
+    void MappedFile::close() {
+        if (m_data) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0))
+#ifdef _WIN32
+        , m_file(std::exchange(other.m_file, nullptr)),
+          m_mapping(std::exchange(other.m_mapping, nullptr))
+#endif
+    {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            this->close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        this->close();
+    }
+}
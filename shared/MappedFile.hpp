@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <Geode/Result.hpp>
+
+namespace utils {
+    /// Read-only memory mapping of a whole file.
+    /// The view stays valid until the mapping is destroyed, so several consumers can share one copy.
+    class MappedFile {
+    public:
+        static geode::Result<MappedFile> open(std::string const& path);
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+        ~MappedFile();
+
+        [[nodiscard]] std::span<uint8_t const> data() const { return {m_data, m_size}; }
+        [[nodiscard]] size_t size() const { return m_size; }
+
+    private:
+        MappedFile() = default;
+        void close();
+
+        uint8_t const* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+    };
+}
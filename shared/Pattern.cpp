@@ -0,0 +1,137 @@
+#include "Pattern.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <fmt/format.h>
+
+namespace bromascan {
+    static sinaps::token_t toToken(MaskedByte byte) {
+        if (byte.mask == 0) {
+            return sinaps::token_t(sinaps::token_t::type_t::wildcard);
+        }
+        if (byte.mask == 0xFF) {
+            return sinaps::token_t(byte.value);
+        }
+        return sinaps::token_t(byte.value, byte.mask);
+    }
+
+    static uint16_t getKey(MaskedByte byte) {
+        return static_cast<uint16_t>(byte.value | (byte.mask << 8));
+    }
+
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+
+    /// Text of every canonical masked byte (3^8 of them), taken from sinaps itself
+    /// so the format always matches what `sinaps::find` parses
+    struct Vocabulary {
+        std::unordered_map<std::string, MaskedByte, StringHash, std::equal_to<>> byText;
+        std::unordered_map<uint16_t, std::string> byKey;
+
+        Vocabulary() {
+            auto getText = [](sinaps::token_t token) {
+                auto text = sinaps::to_string({token});
+                auto first = text.find_first_not_of(' ');
+                auto last = text.find_last_not_of(' ');
+                return first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+            };
+
+            auto add = [&](MaskedByte byte) {
+                auto text = getText(toToken(byte));
+                byText.emplace(text, byte);
+                byKey.emplace(getKey(byte), std::move(text));
+            };
+
+            add({0, 0});
+            for (unsigned mask = 1; mask <= 0xFF; ++mask) {
+                // every value with no bits outside of the mask
+                for (unsigned value = mask;; value = (value - 1) & mask) {
+                    add({static_cast<uint8_t>(value), static_cast<uint8_t>(mask)});
+                    if (value == 0) break;
+                }
+            }
+
+            // generators may spell full and empty masks as masked tokens, accept those when parsing too
+            byText.emplace(getText(sinaps::token_t(0, 0)), MaskedByte{0, 0});
+            for (unsigned value = 0; value <= 0xFF; ++value) {
+                auto byte = static_cast<uint8_t>(value);
+                byText.emplace(getText(sinaps::token_t(byte, 0xFF)), MaskedByte{byte, 0xFF});
+            }
+        }
+    };
+
+    static Vocabulary const& getVocabulary() {
+        static Vocabulary vocabulary;
+        return vocabulary;
+    }
+
+    geode::Result<std::vector<MaskedByte>> parsePattern(std::string_view pattern) {
+        auto const& vocabulary = getVocabulary();
+
+        std::vector<MaskedByte> bytes;
+        bytes.reserve(pattern.size() / 3 + 1);
+        while (!pattern.empty()) {
+            auto end = pattern.find(' ');
+            auto word = pattern.substr(0, end);
+            pattern.remove_prefix(end == std::string_view::npos ? pattern.size() : end + 1);
+            if (word.empty()) {
+                continue;
+            }
+
+            auto it = vocabulary.byText.find(word);
+            if (it == vocabulary.byText.end()) {
+                return geode::Err(fmt::format("Unsupported pattern token: {}", word));
+            }
+            bytes.push_back(it->second);
+        }
+
+        return geode::Ok(std::move(bytes));
+    }
+
+    std::string formatPattern(std::span<MaskedByte const> pattern) {
+        auto const& vocabulary = getVocabulary();
+
+        std::string text;
+        text.reserve(pattern.size() * 3);
+        for (auto byte : pattern) {
+            // bits outside of the mask never matter, drop them to hit the canonical entry
+            byte.value &= byte.mask;
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += vocabulary.byKey.at(getKey(byte));
+        }
+
+        return text;
+    }
+
+    void toTokens(std::span<MaskedByte const> pattern, std::vector<sinaps::token_t>& out) {
+        out.clear();
+        out.reserve(pattern.size());
+        for (auto byte : pattern) {
+            out.push_back(toToken(byte));
+        }
+    }
+
+    ScanWork measureScan(std::span<uint8_t const> data, std::span<MaskedByte const> pattern, size_t step) {
+        ScanWork work;
+        if (pattern.empty() || data.size() < pattern.size()) {
+            return work;
+        }
+
+        for (size_t position = 0; position + pattern.size() <= data.size(); position += step) {
+            size_t matched = 0;
+            while (matched < pattern.size() && !((data[position + matched] ^ pattern[matched].value) & pattern[matched].mask)) {
+                ++matched;
+            }
+
+            if (matched != 0) {
+                ++work.candidates;
+                work.compared += std::min(matched, pattern.size() - 1);
+            }
+        }
+        return work;
+    }
+}
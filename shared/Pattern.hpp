@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Geode/Result.hpp>
+#include <sinaps.hpp>
+
+namespace bromascan {
+    /// Pattern byte matching `value` on the bits set in `mask`, a zero mask is a wildcard
+    struct MaskedByte {
+        uint8_t value = 0;
+        uint8_t mask = 0xFF;
+
+        bool operator==(MaskedByte const&) const = default;
+    };
+
+    /// Parses a pattern in the sinaps text format (space separated tokens) into masked bytes
+    geode::Result<std::vector<MaskedByte>> parsePattern(std::string_view pattern);
+
+    /// Formats masked bytes in the sinaps text format
+    std::string formatPattern(std::span<MaskedByte const> pattern);
+
+    /// Converts masked bytes into sinaps tokens, replacing the contents of `out`
+    void toTokens(std::span<MaskedByte const> pattern, std::vector<sinaps::token_t>& out);
+
+    /// Work done trying `pattern` at every `step` bytes of `data`, the way `sinaps::find` walks it
+    struct ScanWork {
+        uint64_t candidates = 0; // positions where the first byte matched
+        uint64_t compared = 0; // bytes compared past the first one
+    };
+
+    /// Measures the work of a scan over all of `data`, not stopping at the first match
+    ScanWork measureScan(std::span<uint8_t const> data, std::span<MaskedByte const> pattern, size_t step);
+}
@@ -0,0 +1,668 @@
+#include "PatternFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <fmt/format.h>
+
+#include "JsonReader.hpp"
+#include "broma/Reader.hpp"
+
+namespace bromascan {
+    // indentation of the members of a method object in `dump(2)` output
+    constexpr std::string_view methodMemberIndent = "\n          ";
+
+    constexpr std::string_view argsMemberPrefix = "\"args\": ";
+    constexpr std::string_view constMember = "\"const\": true";
+
+    static std::string formatMember(std::string_view key, nlohmann::json const& value) {
+        auto text = value.dump(2);
+
+        std::string member = fmt::format("\"{}\": ", key);
+        member.reserve(member.size() + text.size());
+        for (char c : text) {
+            if (c == '\n') {
+                member += methodMemberIndent;
+            } else {
+                member += c;
+            }
+        }
+        return member;
+    }
+
+    std::span<std::string_view const> PatternClass::getMetadata(size_t method) const {
+        auto start = method == 0 ? 0 : metadataEnd[method - 1];
+        return std::span(metadata).subspan(start, metadataEnd[method] - start);
+    }
+
+    std::span<MaskedByte const> PatternClass::getPatternBytes(size_t method) const {
+        if (method >= patternBytes.size()) {
+            return {};
+        }
+        return patternBytes[method];
+    }
+
+    std::span<MaskedByte const> PatternClass::getCallSiteBytes(size_t method) const {
+        if (method >= callSiteBytes.size()) {
+            return {};
+        }
+        return callSiteBytes[method];
+    }
+
+    PatternClass PatternClass::fromBinding(ClassBinding binding) {
+        PatternClass patternClass;
+
+        std::vector<std::string> members;
+        for (auto const& method : binding.methods) {
+            MethodBinding plain;
+            plain.method = method.method;
+
+            nlohmann::json json = plain;
+            for (auto const& [key, value] : json.items()) {
+                members.push_back(formatMember(key, value));
+            }
+            patternClass.metadataEnd.push_back(static_cast<uint32_t>(members.size()));
+        }
+        members.push_back(formatMember("name", binding.name));
+
+        // one buffer backs every view, its heap storage stays put when the class is moved
+        size_t totalSize = 0;
+        for (auto const& member : members) {
+            totalSize += member.size();
+        }
+        patternClass.storage.reserve(totalSize);
+        for (auto const& member : members) {
+            patternClass.storage.insert(patternClass.storage.end(), member.begin(), member.end());
+        }
+
+        size_t offset = 0;
+        for (auto const& member : members) {
+            patternClass.metadata.emplace_back(patternClass.storage.data() + offset, member.size());
+            offset += member.size();
+        }
+
+        patternClass.rawName = patternClass.metadata.back();
+        patternClass.metadata.pop_back();
+        patternClass.binding = std::move(binding);
+        return patternClass;
+    }
+
+    bool isPatternDatabase(std::span<uint8_t const> data) {
+        if (data.size() < sizeof(bpdb::Header)) {
+            return false;
+        }
+
+        uint32_t magic;
+        std::memcpy(&magic, data.data(), sizeof(magic));
+        return magic == bpdb::magic;
+    }
+
+    // keys of a method object that drive the scan, every other member is passed through untouched
+    constexpr std::array<std::string_view, 11> methodHintKeys = {
+        "pattern", "anchor", "symbol", "start", "hash", "estimate", "cost", "slot", "offset", "caller", "callsite"
+    };
+
+    static geode::Result<bool> readMethodHint(utils::JsonReader& reader, std::string_view key, MethodBinding& method) {
+        if (key == "pattern") {
+            GEODE_UNWRAP_INTO(method.pattern, reader.readString());
+        } else if (key == "anchor") {
+            GEODE_UNWRAP_INTO(method.anchor, reader.readString());
+        } else if (key == "symbol") {
+            GEODE_UNWRAP_INTO(method.symbol, reader.readString());
+        } else if (key == "start") {
+            GEODE_UNWRAP_INTO(auto start, reader.readInteger());
+            method.start = static_cast<uint32_t>(start);
+        } else if (key == "hash") {
+            GEODE_UNWRAP_INTO(auto text, reader.readString());
+            uint64_t hash = 0;
+            auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), hash, 16);
+            if (error != std::errc{} || end != text.data() + text.size()) {
+                return geode::Err(fmt::format("Invalid method hash: {}", text));
+            }
+            method.hash = hash;
+        } else if (key == "estimate") {
+            GEODE_UNWRAP_INTO(auto estimate, reader.readInteger());
+            method.estimate = static_cast<uint32_t>(estimate);
+        } else if (key == "cost") {
+            PatternCost cost;
+            GEODE_UNWRAP(reader.beginObject());
+            while (true) {
+                GEODE_UNWRAP_INTO(auto costKey, reader.nextKey());
+                if (!costKey) break;
+
+                if (costKey == "candidates") {
+                    GEODE_UNWRAP_INTO(auto candidates, reader.readInteger());
+                    cost.candidates = static_cast<uint32_t>(candidates);
+                } else if (costKey == "compared") {
+                    GEODE_UNWRAP_INTO(auto compared, reader.readInteger());
+                    cost.compared = static_cast<uint32_t>(compared);
+                } else {
+                    GEODE_UNWRAP(reader.skipValue());
+                }
+            }
+            method.cost = cost;
+        } else if (key == "slot") {
+            GEODE_UNWRAP_INTO(auto slot, reader.readInteger());
+            method.slot = static_cast<int32_t>(slot);
+        } else if (key == "offset") {
+            GEODE_UNWRAP_INTO(auto offset, reader.readInteger());
+            method.offset = static_cast<uintptr_t>(offset);
+        } else if (key == "caller") {
+            CallerRef caller;
+            GEODE_UNWRAP(reader.beginObject());
+            while (true) {
+                GEODE_UNWRAP_INTO(auto callerKey, reader.nextKey());
+                if (!callerKey) break;
+
+                if (callerKey == "pattern") {
+                    GEODE_UNWRAP_INTO(caller.pattern, reader.readString());
+                } else if (callerKey == "index") {
+                    GEODE_UNWRAP_INTO(auto index, reader.readInteger());
+                    caller.index = static_cast<size_t>(index);
+                } else {
+                    GEODE_UNWRAP(reader.skipValue());
+                }
+            }
+            method.caller = std::move(caller);
+        } else if (key == "callsite") {
+            CallSiteRef callSite;
+            GEODE_UNWRAP(reader.beginObject());
+            while (true) {
+                GEODE_UNWRAP_INTO(auto callSiteKey, reader.nextKey());
+                if (!callSiteKey) break;
+
+                if (callSiteKey == "pattern") {
+                    GEODE_UNWRAP_INTO(callSite.pattern, reader.readString());
+                } else if (callSiteKey == "offset") {
+                    GEODE_UNWRAP_INTO(auto offset, reader.readInteger());
+                    callSite.offset = static_cast<uint32_t>(offset);
+                } else {
+                    GEODE_UNWRAP(reader.skipValue());
+                }
+            }
+            method.callSite = std::move(callSite);
+        } else {
+            return geode::Ok(false);
+        }
+        return geode::Ok(true);
+    }
+
+    static geode::Result<> readJsonClass(utils::JsonReader& reader, PatternClass& patternClass) {
+        GEODE_UNWRAP(reader.beginObject());
+        while (true) {
+            GEODE_UNWRAP_INTO(auto key, reader.nextKey());
+            if (!key) break;
+
+            if (key == "name") {
+                auto start = reader.getKeyStart();
+                GEODE_UNWRAP_INTO(patternClass.binding.name, reader.readString());
+                patternClass.rawName = reader.getSlice(start);
+                continue;
+            }
+
+            if (key != "functions") {
+                GEODE_UNWRAP(reader.skipValue());
+                continue;
+            }
+
+            GEODE_UNWRAP(reader.beginArray());
+            while (true) {
+                GEODE_UNWRAP_INTO(bool hasMethod, reader.nextElement());
+                if (!hasMethod) break;
+
+                auto& method = patternClass.binding.methods.emplace_back();
+                GEODE_UNWRAP(reader.beginObject());
+                while (true) {
+                    GEODE_UNWRAP_INTO(auto methodKey, reader.nextKey());
+                    if (!methodKey) break;
+
+                    // a null hint is the same as a missing one, null passthrough members are kept as they are
+                    auto start = reader.getKeyStart();
+                    if (reader.skipNull()) {
+                        if (std::ranges::find(methodHintKeys, methodKey.value()) == methodHintKeys.end()) {
+                            patternClass.metadata.push_back(reader.getSlice(start));
+                        }
+                        continue;
+                    }
+
+                    GEODE_UNWRAP_INTO(bool isHint, readMethodHint(reader, methodKey.value(), method));
+                    if (isHint) {
+                        continue;
+                    }
+
+                    // name, argument types and constness are kept for logging and method IDs
+                    if (methodKey == "name") {
+                        GEODE_UNWRAP_INTO(method.method.name, reader.readString());
+                    } else if (methodKey == "args") {
+                        GEODE_UNWRAP(readArgs(reader, method.method.args));
+                    } else if (methodKey == "const") {
+                        GEODE_UNWRAP_INTO(method.method.isConst, reader.readBool());
+                    } else {
+                        GEODE_UNWRAP(reader.skipValue());
+                    }
+                    patternClass.metadata.push_back(reader.getSlice(start));
+                }
+                patternClass.metadataEnd.push_back(static_cast<uint32_t>(patternClass.metadata.size()));
+            }
+        }
+        return geode::Ok();
+    }
+
+    static geode::Result<Platform> readPatternsJson(
+        std::span<uint8_t const> data,
+        std::deque<PatternClass>& classes,
+        std::function<void(Platform)> const& onPlatform,
+        std::function<void(PatternClass&)> const& onClass
+    ) {
+        utils::JsonReader reader({reinterpret_cast<char const*>(data.data()), data.size()});
+
+        std::optional<Platform> platform;
+        GEODE_UNWRAP(reader.beginObject());
+        while (true) {
+            GEODE_UNWRAP_INTO(auto key, reader.nextKey());
+            if (!key) break;
+
+            if (key == "platform") {
+                GEODE_UNWRAP_INTO(auto name, reader.readString());
+                GEODE_UNWRAP_INTO(platform, parsePlatform(name));
+                onPlatform(platform.value());
+            } else if (key == "classes") {
+                GEODE_UNWRAP(reader.beginArray());
+                while (true) {
+                    GEODE_UNWRAP_INTO(bool hasClass, reader.nextElement());
+                    if (!hasClass) break;
+
+                    auto& patternClass = classes.emplace_back();
+                    GEODE_UNWRAP(readJsonClass(reader, patternClass));
+                    onClass(patternClass);
+                }
+            } else {
+                GEODE_UNWRAP(reader.skipValue());
+            }
+        }
+
+        if (!platform.has_value()) {
+            return geode::Err("Missing platform");
+        }
+        return geode::Ok(platform.value());
+    }
+
+    static geode::Result<Platform> readPatternDatabase(
+        std::span<uint8_t const> data,
+        std::deque<PatternClass>& classes,
+        std::function<void(Platform)> const& onPlatform,
+        std::function<void(PatternClass&)> const& onClass
+    ) {
+        bpdb::Header header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.version != bpdb::version) {
+            return geode::Err(fmt::format("Unsupported pattern database version: {}", header.version));
+        }
+
+        if (header.platform > static_cast<uint32_t>(Platform::ANDROID64)) {
+            return geode::Err(fmt::format("Unknown platform in pattern database: {}", header.platform));
+        }
+
+        uint64_t classesOffset = sizeof(bpdb::Header);
+        uint64_t methodsOffset = classesOffset + uint64_t{header.classCount} * sizeof(bpdb::ClassEntry);
+        uint64_t membersOffset = methodsOffset + uint64_t{header.methodCount} * sizeof(bpdb::MethodEntry);
+        uint64_t patternsOffset = membersOffset + uint64_t{header.memberCount} * sizeof(bpdb::Ref);
+        uint64_t stringsOffset = patternsOffset + uint64_t{header.patternByteCount} * sizeof(MaskedByte);
+        if (stringsOffset + header.stringsSize > data.size()) {
+            return geode::Err("Truncated pattern database");
+        }
+
+        auto classEntries = reinterpret_cast<bpdb::ClassEntry const*>(data.data() + classesOffset);
+        auto methodEntries = reinterpret_cast<bpdb::MethodEntry const*>(data.data() + methodsOffset);
+        auto memberRefs = reinterpret_cast<bpdb::Ref const*>(data.data() + membersOffset);
+        auto patternBytes = std::span(
+            reinterpret_cast<MaskedByte const*>(data.data() + patternsOffset),
+            header.patternByteCount
+        );
+        auto strings = std::string_view(reinterpret_cast<char const*>(data.data() + stringsOffset), header.stringsSize);
+
+        auto isValid = [](bpdb::Ref ref, size_t size) {
+            return ref.offset <= size && ref.size <= size - ref.offset;
+        };
+
+        auto platform = static_cast<Platform>(header.platform);
+        onPlatform(platform);
+
+        for (uint32_t i = 0; i < header.classCount; ++i) {
+            auto const& classEntry = classEntries[i];
+            if (!isValid({classEntry.firstMethod, classEntry.methodCount}, header.methodCount) ||
+                !isValid(classEntry.name, strings.size()) || !isValid(classEntry.rawName, strings.size())) {
+                return geode::Err("Corrupted pattern database class directory");
+            }
+
+            auto& patternClass = classes.emplace_back();
+            patternClass.binding.name = strings.substr(classEntry.name.offset, classEntry.name.size);
+            patternClass.rawName = strings.substr(classEntry.rawName.offset, classEntry.rawName.size);
+            patternClass.binding.methods.reserve(classEntry.methodCount);
+            patternClass.patternBytes.resize(classEntry.methodCount);
+            patternClass.callSiteBytes.resize(classEntry.methodCount);
+
+            for (uint32_t j = 0; j < classEntry.methodCount; ++j) {
+                auto const& entry = methodEntries[classEntry.firstMethod + j];
+                bool valid = isValid(entry.name, strings.size()) &&
+                             isValid(entry.anchor, strings.size()) &&
+                             isValid(entry.symbol, strings.size()) &&
+                             isValid(entry.pattern, patternBytes.size()) &&
+                             isValid(entry.callerPattern, patternBytes.size()) &&
+                             isValid(entry.callSitePattern, patternBytes.size()) &&
+                             isValid({entry.firstMember, entry.memberCount}, header.memberCount);
+                if (!valid) {
+                    return geode::Err("Corrupted pattern database method directory");
+                }
+
+                auto& method = patternClass.binding.methods.emplace_back();
+                method.method.name = strings.substr(entry.name.offset, entry.name.size);
+
+                if (entry.flags & bpdb::HasPattern) {
+                    auto bytes = patternBytes.subspan(entry.pattern.offset, entry.pattern.size);
+                    patternClass.patternBytes[j] = bytes;
+                    method.pattern = formatPattern(bytes);
+                }
+                if (entry.flags & bpdb::HasCaller) {
+                    auto bytes = patternBytes.subspan(entry.callerPattern.offset, entry.callerPattern.size);
+                    method.caller = CallerRef{formatPattern(bytes), entry.callerIndex};
+                }
+                if (entry.flags & bpdb::HasCallSite) {
+                    auto bytes = patternBytes.subspan(entry.callSitePattern.offset, entry.callSitePattern.size);
+                    patternClass.callSiteBytes[j] = bytes;
+                    method.callSite = CallSiteRef{formatPattern(bytes), entry.callSiteOffset};
+                }
+                if (entry.flags & bpdb::HasAnchor) {
+                    method.anchor = strings.substr(entry.anchor.offset, entry.anchor.size);
+                }
+                if (entry.flags & bpdb::HasSymbol) {
+                    method.symbol = strings.substr(entry.symbol.offset, entry.symbol.size);
+                }
+                if (entry.flags & bpdb::HasSlot) {
+                    method.slot = entry.slot;
+                }
+                if (entry.flags & bpdb::HasStart) {
+                    method.start = entry.start;
+                }
+                if (entry.flags & bpdb::HasHash) {
+                    method.hash = entry.hash;
+                }
+                if (entry.flags & bpdb::HasEstimate) {
+                    method.estimate = entry.estimate;
+                }
+                if (entry.flags & bpdb::HasCost) {
+                    method.cost = PatternCost{entry.candidates, entry.compared};
+                }
+                if (entry.flags & bpdb::HasOffset) {
+                    method.offset = static_cast<uintptr_t>(entry.offset);
+                }
+
+                for (uint32_t k = 0; k < entry.memberCount; ++k) {
+                    auto ref = memberRefs[entry.firstMember + k];
+                    if (!isValid(ref, strings.size())) {
+                        return geode::Err("Corrupted pattern database metadata");
+                    }
+                    auto member = strings.substr(ref.offset, ref.size);
+                    if (member.starts_with(argsMemberPrefix)) {
+                        utils::JsonReader argsReader(member.substr(argsMemberPrefix.size()));
+                        GEODE_UNWRAP(readArgs(argsReader, method.method.args));
+                    } else if (member == constMember) {
+                        method.method.isConst = true;
+                    }
+                    patternClass.metadata.push_back(member);
+                }
+                patternClass.metadataEnd.push_back(static_cast<uint32_t>(patternClass.metadata.size()));
+            }
+
+            onClass(patternClass);
+        }
+
+        return geode::Ok(platform);
+    }
+
+    geode::Result<Platform> readPatterns(
+        std::span<uint8_t const> data,
+        std::deque<PatternClass>& classes,
+        std::function<void(Platform)> const& onPlatform,
+        std::function<void(PatternClass&)> const& onClass
+    ) {
+        if (isPatternDatabase(data)) {
+            return readPatternDatabase(data, classes, onPlatform, onClass);
+        }
+        return readPatternsJson(data, classes, onPlatform, onClass);
+    }
+
+    PatternsJsonWriter::PatternsJsonWriter(Platform platform, bool results)
+        : m_platform(platform), m_results(results) {
+        // nlohmann sorts keys, so results keep "platform" last like before,
+        // patterns put it first so readers can start on the binary early
+        m_out = results
+            ? std::string("{\n  \"classes\": [")
+            : fmt::format("{{\n  \"platform\": \"{}\",\n  \"classes\": [", platform);
+    }
+
+    std::string PatternsJsonWriter::formatClass(PatternClass const& patternClass, bool results) {
+        auto const& methods = patternClass.binding.methods;
+
+        std::string out;
+        std::vector<std::string> generated;
+        std::vector<std::string_view> members;
+        bool hasMethods = false;
+        for (size_t i = 0; i < methods.size(); ++i) {
+            auto const& method = methods[i];
+            if (results && !method.offset.has_value()) {
+                continue;
+            }
+
+            out += hasMethods ? ",\n        {" : "    {\n      \"functions\": [\n        {";
+            hasMethods = true;
+
+            generated.clear();
+            if (!results) {
+                if (method.pattern) generated.push_back(formatMember("pattern", method.pattern.value()));
+                if (method.anchor) generated.push_back(formatMember("anchor", method.anchor.value()));
+                if (method.symbol) generated.push_back(formatMember("symbol", method.symbol.value()));
+                if (method.slot) generated.push_back(formatMember("slot", method.slot.value()));
+                if (method.start) generated.push_back(formatMember("start", method.start.value()));
+                if (method.hash) generated.push_back(formatMember("hash", fmt::format("{:016x}", method.hash.value())));
+                if (method.estimate) generated.push_back(formatMember("estimate", method.estimate.value()));
+                if (method.cost) {
+                    nlohmann::json cost;
+                    cost["candidates"] = method.cost->candidates;
+                    cost["compared"] = method.cost->compared;
+                    generated.push_back(formatMember("cost", cost));
+                }
+                if (method.caller) {
+                    nlohmann::json caller;
+                    caller["pattern"] = method.caller->pattern;
+                    caller["index"] = method.caller->index;
+                    generated.push_back(formatMember("caller", caller));
+                }
+                if (method.callSite) {
+                    nlohmann::json callSite;
+                    callSite["pattern"] = method.callSite->pattern;
+                    callSite["offset"] = method.callSite->offset;
+                    generated.push_back(formatMember("callsite", callSite));
+                }
+            }
+            if (method.offset) {
+                generated.push_back(formatMember("offset", method.offset.value()));
+            }
+
+            auto metadata = patternClass.getMetadata(i);
+            members.assign(metadata.begin(), metadata.end());
+            members.insert(members.end(), generated.begin(), generated.end());
+            std::ranges::sort(members); // members start with their quoted key, so this sorts by key
+
+            for (size_t j = 0; j < members.size(); ++j) {
+                if (j > 0) out += ',';
+                out += methodMemberIndent;
+                out += members[j];
+            }
+            out += "\n        }";
+        }
+
+        if (!hasMethods) {
+            if (results) {
+                return {};
+            }
+            out += "    {\n      \"functions\": []";
+        } else {
+            out += "\n      ]";
+        }
+
+        if (!patternClass.rawName.empty()) {
+            out += ",\n      ";
+            out += patternClass.rawName;
+        }
+        out += "\n    }";
+        return out;
+    }
+
+    void PatternsJsonWriter::add(PatternClass const& patternClass) {
+        this->append(formatClass(patternClass, m_results));
+    }
+
+    void PatternsJsonWriter::append(std::string_view classText) {
+        if (classText.empty()) {
+            return;
+        }
+
+        m_out += m_hasClasses ? ",\n" : "\n";
+        m_out += classText;
+        m_hasClasses = true;
+    }
+
+    std::string PatternsJsonWriter::finish() {
+        m_out += m_hasClasses ? "\n  ]" : "]";
+        if (m_results) {
+            m_out += fmt::format(",\n  \"platform\": \"{}\"", m_platform);
+        }
+        m_out += "\n}";
+        return std::move(m_out);
+    }
+
+    bpdb::Ref PatternDatabaseWriter::addString(std::string_view str) {
+        auto [it, inserted] = m_stringRefs.try_emplace(std::string(str));
+        if (inserted) {
+            it->second = {static_cast<uint32_t>(m_strings.size()), static_cast<uint32_t>(str.size())};
+            m_strings += str;
+        }
+        return it->second;
+    }
+
+    geode::Result<bpdb::Ref> PatternDatabaseWriter::addPattern(std::string_view pattern) {
+        if (auto it = m_patternRefs.find(std::string(pattern)); it != m_patternRefs.end()) {
+            return geode::Ok(it->second);
+        }
+
+        GEODE_UNWRAP_INTO(auto bytes, parsePattern(pattern));
+        bpdb::Ref ref{static_cast<uint32_t>(m_patternBytes.size()), static_cast<uint32_t>(bytes.size())};
+        m_patternBytes.insert(m_patternBytes.end(), bytes.begin(), bytes.end());
+        m_patternRefs.emplace(std::string(pattern), ref);
+        return geode::Ok(ref);
+    }
+
+    geode::Result<> PatternDatabaseWriter::add(PatternClass const& patternClass) {
+        auto const& methods = patternClass.binding.methods;
+
+        bpdb::ClassEntry classEntry{};
+        classEntry.name = this->addString(patternClass.binding.name);
+        classEntry.rawName = this->addString(patternClass.rawName);
+        classEntry.firstMethod = static_cast<uint32_t>(m_methods.size());
+        classEntry.methodCount = static_cast<uint32_t>(methods.size());
+
+        for (size_t i = 0; i < methods.size(); ++i) {
+            auto const& method = methods[i];
+
+            bpdb::MethodEntry entry{};
+            entry.name = this->addString(method.method.name);
+            if (method.pattern) {
+                GEODE_UNWRAP_INTO(entry.pattern, this->addPattern(method.pattern.value()));
+                entry.flags |= bpdb::HasPattern;
+            }
+            if (method.caller) {
+                GEODE_UNWRAP_INTO(entry.callerPattern, this->addPattern(method.caller->pattern));
+                entry.callerIndex = static_cast<uint32_t>(method.caller->index);
+                entry.flags |= bpdb::HasCaller;
+            }
+            if (method.callSite) {
+                GEODE_UNWRAP_INTO(entry.callSitePattern, this->addPattern(method.callSite->pattern));
+                entry.callSiteOffset = method.callSite->offset;
+                entry.flags |= bpdb::HasCallSite;
+            }
+            if (method.anchor) {
+                entry.anchor = this->addString(method.anchor.value());
+                entry.flags |= bpdb::HasAnchor;
+            }
+            if (method.symbol) {
+                entry.symbol = this->addString(method.symbol.value());
+                entry.flags |= bpdb::HasSymbol;
+            }
+            if (method.slot) {
+                entry.slot = method.slot.value();
+                entry.flags |= bpdb::HasSlot;
+            }
+            if (method.start) {
+                entry.start = method.start.value();
+                entry.flags |= bpdb::HasStart;
+            }
+            if (method.hash) {
+                entry.hash = method.hash.value();
+                entry.flags |= bpdb::HasHash;
+            }
+            if (method.estimate) {
+                entry.estimate = method.estimate.value();
+                entry.flags |= bpdb::HasEstimate;
+            }
+            if (method.cost) {
+                entry.candidates = method.cost->candidates;
+                entry.compared = method.cost->compared;
+                entry.flags |= bpdb::HasCost;
+            }
+            if (method.offset) {
+                entry.offset = method.offset.value();
+                entry.flags |= bpdb::HasOffset;
+            }
+
+            auto metadata = patternClass.getMetadata(i);
+            entry.firstMember = static_cast<uint32_t>(m_members.size());
+            entry.memberCount = static_cast<uint32_t>(metadata.size());
+            for (auto member : metadata) {
+                m_members.push_back(this->addString(member));
+            }
+
+            m_methods.push_back(entry);
+        }
+
+        m_classes.push_back(classEntry);
+        return geode::Ok();
+    }
+
+    std::vector<uint8_t> PatternDatabaseWriter::finish(Platform platform) const {
+        bpdb::Header header{};
+        header.magic = bpdb::magic;
+        header.version = bpdb::version;
+        header.platform = static_cast<uint32_t>(platform);
+        header.classCount = static_cast<uint32_t>(m_classes.size());
+        header.methodCount = static_cast<uint32_t>(m_methods.size());
+        header.memberCount = static_cast<uint32_t>(m_members.size());
+        header.patternByteCount = static_cast<uint32_t>(m_patternBytes.size());
+        header.stringsSize = static_cast<uint32_t>(m_strings.size());
+
+        std::vector<uint8_t> out;
+        auto append = [&out](void const* data, size_t size) {
+            auto bytes = static_cast<uint8_t const*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        };
+
+        append(&header, sizeof(header));
+        append(m_classes.data(), m_classes.size() * sizeof(bpdb::ClassEntry));
+        append(m_methods.data(), m_methods.size() * sizeof(bpdb::MethodEntry));
+        append(m_members.data(), m_members.size() * sizeof(bpdb::Ref));
+        append(m_patternBytes.data(), m_patternBytes.size() * sizeof(MaskedByte));
+        append(m_strings.data(), m_strings.size());
+        return out;
+    }
+}
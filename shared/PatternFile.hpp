@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <Geode/Result.hpp>
+
+#include "bromascan.hpp"
+#include "Pattern.hpp"
+
+namespace bromascan {
+    /// Class as read from a patterns file. Methods only carry their name and resolution hints,
+    /// everything else stays as raw `"key": value` JSON members that are written back verbatim.
+    struct PatternClass {
+        ClassBinding binding;
+        std::string_view rawName; // `"name": ...` member of the class object
+        std::vector<std::string_view> metadata;
+        std::vector<uint32_t> metadataEnd; // end of each method's members in `metadata`
+        std::vector<std::span<MaskedByte const>> patternBytes; // per method, only filled from databases
+        std::vector<std::span<MaskedByte const>> callSiteBytes; // same for call site patterns
+        std::vector<char> storage; // backs the views of classes built in memory
+
+        [[nodiscard]] std::span<std::string_view const> getMetadata(size_t method) const;
+        [[nodiscard]] std::span<MaskedByte const> getPatternBytes(size_t method) const;
+        [[nodiscard]] std::span<MaskedByte const> getCallSiteBytes(size_t method) const;
+
+        /// Builds the pattern file form of a generated class
+        static PatternClass fromBinding(ClassBinding binding);
+    };
+
+    /// On-disk layout of the binary pattern database (`.bpdb`).
+    /// The header is followed back to back by the class directory, the method directory,
+    /// metadata member refs, masked pattern bytes and the string table.
+    namespace bpdb {
+        constexpr uint32_t magic = 0x42445042; // "BPDB"
+        constexpr uint32_t version = 8;
+
+        /// Range in the string table, or in the pattern bytes for patterns
+        struct Ref {
+            uint32_t offset = 0;
+            uint32_t size = 0;
+        };
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t platform;
+            uint32_t classCount;
+            uint32_t methodCount;
+            uint32_t memberCount;
+            uint32_t patternByteCount;
+            uint32_t stringsSize;
+        };
+
+        struct ClassEntry {
+            Ref name;
+            Ref rawName;
+            uint32_t firstMethod;
+            uint32_t methodCount;
+        };
+
+        enum MethodFlags : uint32_t {
+            HasPattern = 1 << 0,
+            HasCaller = 1 << 1,
+            HasAnchor = 1 << 2,
+            HasSymbol = 1 << 3,
+            HasSlot = 1 << 4,
+            HasOffset = 1 << 5,
+            HasStart = 1 << 6,
+            HasHash = 1 << 7,
+            HasEstimate = 1 << 8,
+            HasCallSite = 1 << 9,
+            HasCost = 1 << 10,
+        };
+
+        struct MethodEntry {
+            uint64_t offset;
+            uint64_t hash;
+            Ref name;
+            Ref pattern;
+            Ref callerPattern;
+            Ref callSitePattern;
+            Ref anchor;
+            Ref symbol;
+            uint32_t callerIndex;
+            uint32_t callSiteOffset;
+            int32_t slot;
+            uint32_t start;
+            uint32_t estimate;
+            uint32_t candidates;
+            uint32_t compared;
+            uint32_t flags;
+            uint32_t firstMember;
+            uint32_t memberCount;
+        };
+    }
+
+    bool isPatternDatabase(std::span<uint8_t const> data);
+
+    /// Reads a JSON patterns file or a pattern database. Every class is appended to `classes` and handed to
+    /// `onClass` as soon as it is complete, `onPlatform` fires as soon as the platform is known.
+    /// The classes keep views into `data`, so it must outlive them.
+    geode::Result<Platform> readPatterns(
+        std::span<uint8_t const> data,
+        std::deque<PatternClass>& classes,
+        std::function<void(Platform)> const& onPlatform,
+        std::function<void(PatternClass&)> const& onClass
+    );
+
+    /// Writes classes in the same layout as `nlohmann::json::dump(2)`
+    class PatternsJsonWriter {
+    public:
+        /// Results only keep methods with an offset and drop all resolution hints,
+        /// patterns keep everything and put the platform first
+        PatternsJsonWriter(Platform platform, bool results);
+
+        void add(PatternClass const& patternClass);
+        /// Appends a class formatted by `formatClass`, empty text is skipped
+        void append(std::string_view classText);
+        std::string finish();
+
+        /// Formats a single class object without touching any writer state, so classes can be
+        /// formatted in parallel and appended in order. Returns an empty string if the class is dropped.
+        static std::string formatClass(PatternClass const& patternClass, bool results);
+
+    private:
+        std::string m_out;
+        Platform m_platform;
+        bool m_results;
+        bool m_hasClasses = false;
+    };
+
+    /// Builds a binary pattern database, strings and patterns are deduplicated
+    /// so repeated metadata like `"args": []` is stored once
+    class PatternDatabaseWriter {
+    public:
+        geode::Result<> add(PatternClass const& patternClass);
+        std::vector<uint8_t> finish(Platform platform) const;
+
+    private:
+        bpdb::Ref addString(std::string_view str);
+        geode::Result<bpdb::Ref> addPattern(std::string_view pattern);
+
+        std::vector<bpdb::ClassEntry> m_classes;
+        std::vector<bpdb::MethodEntry> m_methods;
+        std::vector<bpdb::Ref> m_members;
+        std::vector<MaskedByte> m_patternBytes;
+        std::string m_strings;
+        std::unordered_map<std::string, bpdb::Ref> m_stringRefs;
+        std::unordered_map<std::string, bpdb::Ref> m_patternRefs;
+    };
+}
@@ -0,0 +1,151 @@
+#include "PatternSet.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+
+#include "ThreadPool.hpp"
+
+namespace bromascan {
+    // positions swept by a single task
+    constexpr size_t chunkSize = 0x100000;
+
+    // patterns without a fully masked byte pair can't be bucketed and get scanned on their own
+    constexpr uint32_t noKey = ~uint32_t{0};
+
+    static bool matchesAt(std::span<uint8_t const> data, size_t position, std::span<MaskedByte const> pattern) {
+        if (position + pattern.size() > data.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if ((data[position + i] ^ pattern[i].value) & pattern[i].mask) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void addMatch(PatternSet::Matches& matches, size_t position) {
+        if (matches.count == 0 || position < matches.first) {
+            matches.first = position;
+        }
+        matches.count = std::min<uint32_t>(matches.count + 1, 2);
+    }
+
+    // chunks finish in any order, the earliest match is kept
+    static void mergeMatches(PatternSet::Matches& into, PatternSet::Matches const& from) {
+        if (from.count != 0 && (into.count == 0 || from.first < into.first)) {
+            into.first = from.first;
+        }
+        into.count = std::min<uint32_t>(into.count + from.count, 2);
+    }
+
+    uint32_t PatternSet::add(std::vector<MaskedByte> pattern) {
+        m_patterns.push_back(std::move(pattern));
+        return static_cast<uint32_t>(m_patterns.size() - 1);
+    }
+
+    std::vector<PatternSet::Matches> PatternSet::match(
+        std::span<uint8_t const> data,
+        size_t align,
+        utils::ThreadPool& pool
+    ) const {
+        std::vector<Matches> results(m_patterns.size());
+        if (m_patterns.empty() || data.size() < 2) {
+            return results;
+        }
+
+        // how often each byte pair occurs decides which pair of a pattern is the rarest
+        auto frequencies = std::make_unique<std::array<uint32_t, 0x10000>>();
+        for (size_t i = 0; i + 1 < data.size(); ++i) {
+            auto& count = (*frequencies)[data[i] | data[i + 1] << 8];
+            count += count != ~uint32_t{0};
+        }
+
+        // key offset of each pattern, then the patterns grouped by key
+        std::vector<uint32_t> keyOffsets(m_patterns.size(), noKey);
+        std::vector<uint32_t> bucketStarts(0x10000 + 1);
+        std::vector<uint16_t> keys(m_patterns.size());
+        std::vector<uint32_t> unkeyed;
+        for (uint32_t id = 0; id < m_patterns.size(); ++id) {
+            auto const& pattern = m_patterns[id];
+            uint32_t bestCount = ~uint32_t{0};
+            for (size_t i = 0; i + 1 < pattern.size(); ++i) {
+                if (pattern[i].mask != 0xFF || pattern[i + 1].mask != 0xFF) {
+                    continue;
+                }
+
+                auto key = static_cast<uint16_t>(pattern[i].value | pattern[i + 1].value << 8);
+                if (keyOffsets[id] == noKey || (*frequencies)[key] < bestCount) {
+                    keyOffsets[id] = static_cast<uint32_t>(i);
+                    keys[id] = key;
+                    bestCount = (*frequencies)[key];
+                }
+            }
+
+            if (keyOffsets[id] == noKey) {
+                unkeyed.push_back(id);
+            } else {
+                ++bucketStarts[keys[id] + 1];
+            }
+        }
+
+        for (size_t key = 0; key < 0x10000; ++key) {
+            bucketStarts[key + 1] += bucketStarts[key];
+        }
+
+        std::vector<uint32_t> buckets(bucketStarts.back());
+        auto fill = bucketStarts;
+        for (uint32_t id = 0; id < m_patterns.size(); ++id) {
+            if (keyOffsets[id] != noKey) {
+                buckets[fill[keys[id]]++] = id;
+            }
+        }
+
+        std::mutex mutex;
+        for (size_t chunk = 0; chunk + 1 < data.size(); chunk += chunkSize) {
+            pool.enqueue([&, chunk] {
+                std::vector<Matches> local(m_patterns.size());
+                auto end = std::min(chunk + chunkSize, data.size() - 1);
+                for (size_t position = chunk; position < end; ++position) {
+                    auto key = data[position] | data[position + 1] << 8;
+                    for (auto i = bucketStarts[key]; i < bucketStarts[key + 1]; ++i) {
+                        auto id = buckets[i];
+                        if (position < keyOffsets[id]) {
+                            continue;
+                        }
+
+                        auto start = position - keyOffsets[id];
+                        if (start % align == 0 && matchesAt(data, start, m_patterns[id])) {
+                            addMatch(local[id], start);
+                        }
+                    }
+                }
+
+                std::scoped_lock lock(mutex);
+                for (size_t id = 0; id < local.size(); ++id) {
+                    mergeMatches(results[id], local[id]);
+                }
+            });
+        }
+
+        for (auto id : unkeyed) {
+            pool.enqueue([&, id] {
+                Matches matches;
+                for (size_t start = 0; start < data.size() && matches.count < 2; start += align) {
+                    if (matchesAt(data, start, m_patterns[id])) {
+                        addMatch(matches, start);
+                    }
+                }
+
+                std::scoped_lock lock(mutex);
+                results[id] = matches;
+            });
+        }
+
+        pool.waitAll();
+        return results;
+    }
+}
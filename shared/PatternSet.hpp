@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Pattern.hpp"
+
+namespace utils {
+    class ThreadPool;
+}
+
+namespace bromascan {
+    /// Batch of patterns matched against a binary in a single sweep instead of one scan per pattern.
+    /// Each pattern is keyed by its rarest pair of fully masked bytes, so a position only
+    /// checks the few patterns that share the byte pair found there.
+    class PatternSet {
+    public:
+        /// Matches of one pattern, counting stops at 2 since only uniqueness matters
+        struct Matches {
+            uint32_t count = 0;
+            size_t first = 0; // offset of the first match
+        };
+
+        /// Adds a pattern and returns its index in the results of `match`
+        uint32_t add(std::vector<MaskedByte> pattern);
+
+        /// Finds every pattern in `data`, matches only start at multiples of `align`
+        [[nodiscard]] std::vector<Matches> match(std::span<uint8_t const> data, size_t align, utils::ThreadPool& pool) const;
+
+        [[nodiscard]] size_t size() const { return m_patterns.size(); }
+        [[nodiscard]] bool empty() const { return m_patterns.empty(); }
+
+    private:
+        std::vector<std::vector<MaskedByte>> m_patterns;
+    };
+}
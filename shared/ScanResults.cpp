@@ -0,0 +1,130 @@
+#include "ScanResults.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fmt/format.h>
+
+namespace bromascan {
+    // FNV-1a, each part is prefixed with its length so "ab" + "c" and "a" + "bc" differ
+    static void hashPart(uint64_t& hash, std::string_view part) {
+        constexpr uint64_t prime = 0x100000001b3;
+        auto size = static_cast<uint32_t>(part.size());
+        for (size_t i = 0; i < sizeof(size); ++i) {
+            hash = (hash ^ ((size >> (i * 8)) & 0xFF)) * prime;
+        }
+        for (char c : part) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * prime;
+        }
+    }
+
+    uint64_t getMethodId(
+        std::string_view className, std::string_view methodName, std::span<std::string_view const> argTypes, bool isConst
+    ) {
+        uint64_t hash = 0xcbf29ce484222325;
+        hashPart(hash, className);
+        hashPart(hash, methodName);
+        for (auto type : argTypes) {
+            hashPart(hash, type);
+        }
+        // only hashed for const methods, so the IDs of every other method stay as they were
+        if (isConst) {
+            hashPart(hash, "const");
+        }
+        return hash;
+    }
+
+    uint64_t getMethodId(std::string_view className, Function const& method) {
+        std::vector<std::string_view> argTypes;
+        argTypes.reserve(method.args.size());
+        for (auto const& arg : method.args) {
+            argTypes.push_back(arg.type);
+        }
+        return getMethodId(className, method.name, argTypes, method.isConst);
+    }
+
+    bool isCompactResults(std::span<uint8_t const> data) {
+        if (data.size() < sizeof(bsres::Header)) {
+            return false;
+        }
+
+        uint32_t magic;
+        std::memcpy(&magic, data.data(), sizeof(magic));
+        return magic == bsres::magic;
+    }
+
+    std::vector<uint8_t> writeCompactResults(Platform platform, std::vector<ResolvedMethod> methods) {
+        std::ranges::sort(methods, {}, &ResolvedMethod::offset);
+
+        bsres::Header header{};
+        header.magic = bsres::magic;
+        header.version = bsres::version;
+        header.platform = static_cast<uint32_t>(platform);
+        header.count = static_cast<uint32_t>(methods.size());
+
+        std::vector<uint8_t> out(sizeof(header) + methods.size() * sizeof(uint64_t));
+        std::memcpy(out.data(), &header, sizeof(header));
+        for (size_t i = 0; i < methods.size(); ++i) {
+            std::memcpy(out.data() + sizeof(header) + i * sizeof(uint64_t), &methods[i].id, sizeof(uint64_t));
+        }
+
+        uint64_t previous = 0;
+        for (auto const& method : methods) {
+            auto delta = method.offset - previous;
+            previous = method.offset;
+            do {
+                auto byte = static_cast<uint8_t>(delta & 0x7F);
+                delta >>= 7;
+                out.push_back(delta ? byte | 0x80 : byte);
+            } while (delta);
+        }
+
+        return out;
+    }
+
+    geode::Result<CompactResults> readCompactResults(std::span<uint8_t const> data) {
+        if (!isCompactResults(data)) {
+            return geode::Err("Not a compact scan results file");
+        }
+
+        bsres::Header header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.version != bsres::version) {
+            return geode::Err(fmt::format("Unsupported compact scan results version: {}", header.version));
+        }
+        if (header.platform > static_cast<uint32_t>(Platform::ANDROID64)) {
+            return geode::Err(fmt::format("Unknown platform in compact scan results: {}", header.platform));
+        }
+
+        auto idsSize = uint64_t{header.count} * sizeof(uint64_t);
+        if (sizeof(header) + idsSize > data.size()) {
+            return geode::Err("Truncated compact scan results");
+        }
+
+        CompactResults results;
+        results.platform = static_cast<Platform>(header.platform);
+        results.methods.resize(header.count);
+
+        auto ids = data.subspan(sizeof(header), idsSize);
+        auto deltas = data.subspan(sizeof(header) + idsSize);
+        size_t pos = 0;
+        uint64_t offset = 0;
+        for (size_t i = 0; i < header.count; ++i) {
+            uint64_t delta = 0;
+            for (int shift = 0;; shift += 7) {
+                if (pos >= deltas.size() || shift > 63) {
+                    return geode::Err("Truncated compact scan results");
+                }
+
+                auto byte = deltas[pos++];
+                delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) break;
+            }
+
+            offset += delta;
+            std::memcpy(&results.methods[i].id, ids.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+            results.methods[i].offset = offset;
+        }
+
+        return geode::Ok(std::move(results));
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <Geode/Result.hpp>
+
+#include "bromascan.hpp"
+
+namespace bromascan {
+    /// Stable identity of a method across builds, hashed from the class name, method name,
+    /// argument types and constness (the same key broutil matches Broma functions by)
+    uint64_t getMethodId(
+        std::string_view className, std::string_view methodName, std::span<std::string_view const> argTypes, bool isConst
+    );
+    uint64_t getMethodId(std::string_view className, Function const& method);
+
+    struct ResolvedMethod {
+        uint64_t id;
+        uint64_t offset;
+    };
+
+    /// Compact scan results (`.bsres`): the header is followed by the method IDs and then their
+    /// offsets as ULEB128 deltas, both ordered by offset so most deltas fit in two or three bytes
+    namespace bsres {
+        constexpr uint32_t magic = 0x53525342; // "BSRS"
+        constexpr uint32_t version = 2;
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t platform;
+            uint32_t count;
+        };
+    }
+
+    struct CompactResults {
+        Platform platform;
+        std::vector<ResolvedMethod> methods; // sorted by offset
+    };
+
+    bool isCompactResults(std::span<uint8_t const> data);
+    std::vector<uint8_t> writeCompactResults(Platform platform, std::vector<ResolvedMethod> methods);
+    geode::Result<CompactResults> readCompactResults(std::span<uint8_t const> data);
+}
@@ -0,0 +1,182 @@
+#include "BinaryIndex.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <MappedFile.hpp>
+#include <fmt/format.h>
+
+namespace analysis {
+    constexpr char indexMagic[8] = {'B', 'S', 'I', 'D', 'X', 0, 0, 0};
+
+    struct IndexHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t platform;
+        uint64_t binaryHash;
+        uint32_t chunkCount;
+        uint32_t reserved;
+    };
+
+    struct IndexChunkEntry {
+        uint32_t tag;
+        uint32_t elementSize; // catches layout changes the version bump missed
+        uint32_t tableVersion; // of the code that built the table
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    BinaryIndex BinaryIndex::open(std::string const& binaryFile, uint64_t binaryHash, Platform platform) {
+        BinaryIndex index;
+        index.m_path = fmt::format("{}.{}.bsidx", binaryFile, platform);
+        index.m_binaryHash = binaryHash;
+        index.m_platform = platform;
+
+        auto res = utils::MappedFile::open(index.m_path);
+        if (!res) {
+            return index;
+        }
+
+        index.m_file = std::move(res).unwrap();
+        auto data = index.m_file->data();
+        if (data.size() < sizeof(IndexHeader)) {
+            return index;
+        }
+
+        auto header = reinterpret_cast<IndexHeader const*>(data.data());
+        if (std::memcmp(header->magic, indexMagic, sizeof(indexMagic)) != 0 ||
+            header->version != version ||
+            header->platform != static_cast<uint32_t>(platform) ||
+            header->binaryHash != binaryHash) {
+            return index;
+        }
+
+        auto entriesEnd = sizeof(IndexHeader) + header->chunkCount * sizeof(IndexChunkEntry);
+        if (entriesEnd > data.size()) {
+            return index;
+        }
+
+        auto entries = reinterpret_cast<IndexChunkEntry const*>(data.data() + sizeof(IndexHeader));
+        for (uint32_t i = 0; i < header->chunkCount; ++i) {
+            auto const& entry = entries[i];
+            if (entry.offset > data.size() || entry.size > data.size() - entry.offset) {
+                index.m_chunks.clear();
+                return index;
+            }
+
+            // chunks are 8-aligned, so the tables are read straight from the mapping
+            auto& chunk = index.m_chunks[static_cast<IndexChunk>(entry.tag)];
+            chunk.elementSize = entry.elementSize;
+            chunk.tableVersion = entry.tableVersion;
+            chunk.bytes = data.subspan(entry.offset, entry.size);
+        }
+
+        return index;
+    }
+
+    StringXrefs BinaryIndex::getStringXrefs(bin::Image const& image, Architecture arch) {
+        if (auto refs = this->read<StringRef>(IndexChunk::StringRefs)) {
+            return StringXrefs::fromReferences(image, {refs->begin(), refs->end()});
+        }
+
+        auto xrefs = StringXrefs::build(image, arch);
+        this->write(IndexChunk::StringRefs, xrefs.getAllReferences());
+        return xrefs;
+    }
+
+    VtableIndex BinaryIndex::getVtables(bin::Image const& image) {
+        if (auto pointers = this->read<CodePointer>(IndexChunk::CodePointers)) {
+            return VtableIndex::fromPointers({pointers->begin(), pointers->end()});
+        }
+
+        auto vtables = VtableIndex::build(image);
+        this->write(IndexChunk::CodePointers, vtables.getAllPointers());
+        return vtables;
+    }
+
+    CallGraph BinaryIndex::getCallGraph(std::span<uint8_t const> code, uintptr_t address, Architecture arch) {
+        if (auto edges = this->read<CallEdge>(IndexChunk::CallEdges)) {
+            return CallGraph::fromEdges({edges->begin(), edges->end()});
+        }
+
+        auto graph = CallGraph::build(code, address, arch);
+        this->write(IndexChunk::CallEdges, graph.getEdges());
+        return graph;
+    }
+
+    void BinaryIndex::save(bool verbose) {
+        if (!m_dirty) {
+            return;
+        }
+
+        if (auto res = this->writeFile(); !res) {
+            fmt::println("Warning: {}", res.unwrapErr());
+            return;
+        }
+
+        m_dirty = false;
+        if (verbose) {
+            fmt::println("Saved binary index: {}", m_path);
+        }
+    }
+
+    geode::Result<> BinaryIndex::writeFile() {
+        IndexHeader header{};
+        std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+        header.version = version;
+        header.platform = static_cast<uint32_t>(m_platform);
+        header.binaryHash = m_binaryHash;
+        header.chunkCount = static_cast<uint32_t>(m_chunks.size());
+
+        std::vector<IndexChunkEntry> entries;
+        uint64_t offset = sizeof(IndexHeader) + m_chunks.size() * sizeof(IndexChunkEntry);
+        for (auto const& [tag, chunk] : m_chunks) {
+            auto& entry = entries.emplace_back();
+            entry.tag = static_cast<uint32_t>(tag);
+            entry.elementSize = chunk.elementSize;
+            entry.tableVersion = chunk.tableVersion;
+            entry.offset = offset;
+            entry.size = chunk.bytes.size();
+
+            // keep every chunk 8-aligned so a mapped view can be read in place
+            offset += (entry.size + 7) & ~uint64_t{7};
+        }
+
+        // other processes may have the index mapped, so it is never truncated in place. A new file
+        // replaces it instead, existing mappings (this one included) keep the old contents
+        auto tempPath = fmt::format("{}.{:08x}.tmp", m_path, std::random_device{}());
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return geode::Err(fmt::format("Failed to open index file: {}", tempPath));
+        }
+
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write(reinterpret_cast<char const*>(entries.data()), entries.size() * sizeof(IndexChunkEntry));
+
+        constexpr char padding[8] = {};
+        for (auto const& [tag, chunk] : m_chunks) {
+            auto size = chunk.bytes.size();
+            file.write(reinterpret_cast<char const*>(chunk.bytes.data()), size);
+            file.write(padding, ((size + 7) & ~size_t{7}) - size);
+        }
+
+        file.close();
+        std::error_code error;
+        if (!file) {
+            std::filesystem::remove(tempPath, error);
+            return geode::Err(fmt::format("Failed to write index file: {}", tempPath));
+        }
+
+        std::filesystem::rename(tempPath, m_path, error);
+        if (error) {
+            auto message = error.message();
+            std::filesystem::remove(tempPath, error);
+            return geode::Err(fmt::format("Failed to replace index file {}: {}", m_path, message));
+        }
+
+        return geode::Ok();
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <Geode/Result.hpp>
+
+#include <bromascan.hpp>
+#include <MappedFile.hpp>
+#include <analysis/CallGraph.hpp>
+#include <analysis/StringXrefs.hpp>
+#include <analysis/Vtables.hpp>
+#include <binaries/Image.hpp>
+
+namespace analysis {
+    enum class IndexChunk : uint32_t {
+        CallEdges = 1,
+        StringRefs = 2,
+        CodePointers = 3,
+        DecodedBytes = 4, // genpat's masked instruction sweep of the target segment
+        DecodedLengths = 5, // instruction length at each byte of the same sweep
+        ByteCounts = 6, // histograms behind genpat's scan cost model
+    };
+
+    /// Derived tables of one binary slice, persisted next to the binary as `<binary>.<platform>.bsidx`.
+    /// The file is keyed by a hash of the whole binary, so a patched or updated binary rebuilds it.
+    class BinaryIndex {
+    public:
+        /// Bump whenever the layout or the analyses in this library behind a chunk change
+        static constexpr uint32_t version = 4;
+
+        BinaryIndex() = default;
+
+        /// Loads the index for `binaryFile`, starting empty if it is missing or stale
+        static BinaryIndex open(std::string const& binaryFile, uint64_t binaryHash, Platform platform);
+
+        StringXrefs getStringXrefs(bin::Image const& image, Architecture arch);
+        VtableIndex getVtables(bin::Image const& image);
+        CallGraph getCallGraph(std::span<uint8_t const> code, uintptr_t address, Architecture arch);
+
+        /// Stored table of `tag`, viewed in place in the mapped file. Nothing if it is missing or was written
+        /// with a different element type or `tableVersion`, so it has to be rebuilt. Tables built by code that
+        /// changes independently of the index (like genpat's masks) pass their own version.
+        template <typename T>
+        [[nodiscard]] std::optional<std::span<T const>> read(IndexChunk tag, uint32_t tableVersion = 0) const {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            auto it = m_chunks.find(tag);
+            if (it == m_chunks.end()) {
+                return std::nullopt;
+            }
+
+            auto bytes = it->second.bytes;
+            if (it->second.elementSize != sizeof(T) || it->second.tableVersion != tableVersion ||
+                bytes.size() % sizeof(T) != 0 ||
+                reinterpret_cast<uintptr_t>(bytes.data()) % alignof(T) != 0) {
+                return std::nullopt;
+            }
+            return std::span(reinterpret_cast<T const*>(bytes.data()), bytes.size() / sizeof(T));
+        }
+
+        /// Replaces the table of `tag`, it is written out on the next `save`
+        template <typename T>
+        void write(IndexChunk tag, std::span<T const> values, uint32_t tableVersion = 0) {
+            static_assert(std::is_trivially_copyable_v<T>);
+
+            auto& chunk = m_chunks[tag];
+            chunk.elementSize = sizeof(T);
+            chunk.tableVersion = tableVersion;
+            auto data = reinterpret_cast<uint8_t const*>(values.data());
+            chunk.storage.assign(data, data + values.size_bytes());
+            chunk.bytes = chunk.storage;
+            m_dirty = true;
+        }
+
+        /// Writes the index back if any table had to be built. The index only saves time
+        /// on the next run, so a failure (like a read-only directory) is only a warning.
+        void save(bool verbose);
+
+        [[nodiscard]] std::string const& getPath() const { return m_path; }
+        [[nodiscard]] bool isDirty() const { return m_dirty; }
+
+    private:
+        struct Chunk {
+            uint32_t elementSize = 0;
+            uint32_t tableVersion = 0;
+            std::span<uint8_t const> bytes; // into the mapped file or `storage`
+            std::vector<uint8_t> storage; // only for tables built in this run
+        };
+
+        geode::Result<> writeFile();
+
+        std::optional<utils::MappedFile> m_file;
+        std::string m_path;
+        uint64_t m_binaryHash = 0;
+        Platform m_platform = Platform::WIN;
+        std::map<IndexChunk, Chunk> m_chunks;
+        bool m_dirty = false;
+    };
+}
@@ -0,0 +1,125 @@
+#include "CallGraph.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace analysis {
+    static void decodeAArch64(std::vector<CallEdge>& out, std::span<uint8_t const> code, uintptr_t address) {
+        auto end = address + code.size();
+        for (size_t i = 0; i + 4 <= code.size(); i += 4) {
+            auto insn = *reinterpret_cast<uint32_t const*>(code.data() + i);
+
+            // bl #imm26
+            if ((insn & 0xFC000000) != 0x94000000) {
+                continue;
+            }
+
+            auto imm = static_cast<int32_t>(insn << 6) >> 6;
+            auto site = address + i;
+            auto target = site + static_cast<intptr_t>(imm) * 4;
+            if (target < address || target >= end) {
+                continue; // stubs and other segments
+            }
+
+            out.emplace_back(static_cast<uint32_t>(site), static_cast<uint32_t>(target));
+        }
+    }
+
+    static void decodeAMD64(std::vector<CallEdge>& out, std::span<uint8_t const> code, uintptr_t address) {
+        auto end = address + code.size();
+        for (size_t i = 0; i + 5 <= code.size(); ++i) {
+            // call rel32
+            if (code[i] != 0xE8) {
+                continue;
+            }
+
+            auto rel = *reinterpret_cast<int32_t const*>(code.data() + i + 1);
+            auto site = address + i;
+            auto target = site + 5 + static_cast<intptr_t>(rel);
+
+            // there's no instruction boundary info here, so only accept targets that look
+            // like a function start: inside the segment and aligned the same way the compiler does
+            if (target < address || target >= end || (target & 0xF) != 0) {
+                continue;
+            }
+
+            out.emplace_back(static_cast<uint32_t>(site), static_cast<uint32_t>(target));
+        }
+    }
+
+    std::optional<uintptr_t> decodeCall(std::span<uint8_t const> code, uintptr_t address, size_t offset, Architecture arch) {
+        switch (arch) {
+            case Architecture::AArch64: {
+                if (offset + 4 > code.size()) {
+                    return std::nullopt;
+                }
+
+                uint32_t insn;
+                std::memcpy(&insn, code.data() + offset, sizeof(insn));
+                if ((insn & 0xFC000000) != 0x94000000) {
+                    return std::nullopt;
+                }
+
+                auto imm = static_cast<int32_t>(insn << 6) >> 6;
+                return address + offset + static_cast<intptr_t>(imm) * 4;
+            }
+            case Architecture::AMD64: {
+                if (offset + 5 > code.size() || code[offset] != 0xE8) {
+                    return std::nullopt;
+                }
+
+                int32_t rel;
+                std::memcpy(&rel, code.data() + offset + 1, sizeof(rel));
+                return address + offset + 5 + static_cast<intptr_t>(rel);
+            }
+            case Architecture::Thumb:
+                break;
+        }
+        return std::nullopt;
+    }
+
+    CallGraph CallGraph::build(std::span<uint8_t const> code, uintptr_t address, Architecture arch) {
+        std::vector<CallEdge> edges;
+        switch (arch) {
+            case Architecture::AArch64:
+                decodeAArch64(edges, code, address);
+                break;
+            case Architecture::AMD64:
+                decodeAMD64(edges, code, address);
+                break;
+            case Architecture::Thumb:
+                break; // Thumb-2 isn't decoded, armv7 binaries rely on symbols
+        }
+
+        // linear sweep already yields edges in site order
+        return fromEdges(std::move(edges));
+    }
+
+    CallGraph CallGraph::fromEdges(std::vector<CallEdge> edges) {
+        CallGraph graph;
+        graph.m_bySite = std::move(edges);
+        graph.m_byTarget = graph.m_bySite;
+        std::ranges::stable_sort(graph.m_byTarget, {}, &CallEdge::target);
+
+        return graph;
+    }
+
+    std::optional<uintptr_t> CallGraph::getCallee(uintptr_t caller, size_t index) const {
+        auto it = std::ranges::lower_bound(m_bySite, caller, {}, &CallEdge::site);
+        if (static_cast<size_t>(m_bySite.end() - it) <= index) {
+            return std::nullopt;
+        }
+        return it[index].target;
+    }
+
+    std::span<CallEdge const> CallGraph::getCallsInRange(uintptr_t start, uintptr_t end) const {
+        auto first = std::ranges::lower_bound(m_bySite, start, {}, &CallEdge::site);
+        auto last = std::ranges::lower_bound(first, m_bySite.end(), end, {}, &CallEdge::site);
+        return {first, last};
+    }
+
+    std::span<CallEdge const> CallGraph::getCallers(uintptr_t target) const {
+        auto [first, last] = std::ranges::equal_range(m_byTarget, target, {}, &CallEdge::target);
+        return {first, last};
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <bromascan.hpp>
+
+namespace analysis {
+    /// A single direct call, both addresses are relative to the image base
+    struct CallEdge {
+        uint32_t site;
+        uint32_t target;
+    };
+
+    /// Decodes the direct call (`BL` / `call rel32`) at `offset` into `code` and returns its target.
+    /// `address` is the image-relative address of the first byte of `code`.
+    std::optional<uintptr_t> decodeCall(std::span<uint8_t const> code, uintptr_t address, size_t offset, Architecture arch);
+
+    /// Index of every direct call (`BL` / `call rel32`) inside a code segment.
+    class CallGraph {
+    public:
+        CallGraph() = default;
+
+        /// Decodes the whole segment in one linear pass.
+        /// `address` is the image-relative address of the first byte of `code`.
+        static CallGraph build(std::span<uint8_t const> code, uintptr_t address, Architecture arch);
+
+        /// Rebuilds the lookup tables from previously decoded edges, see `getEdges`.
+        static CallGraph fromEdges(std::vector<CallEdge> edges);
+
+        /// Returns the target of the `index`-th direct call at or after `caller`.
+        [[nodiscard]] std::optional<uintptr_t> getCallee(uintptr_t caller, size_t index) const;
+
+        /// Returns all direct calls with a call site in range [start, end).
+        [[nodiscard]] std::span<CallEdge const> getCallsInRange(uintptr_t start, uintptr_t end) const;
+
+        /// Returns all direct calls that land on `target`.
+        [[nodiscard]] std::span<CallEdge const> getCallers(uintptr_t target) const;
+
+        /// Returns every direct call, sorted by call site.
+        [[nodiscard]] std::span<CallEdge const> getEdges() const { return m_bySite; }
+
+        [[nodiscard]] size_t size() const { return m_bySite.size(); }
+        [[nodiscard]] bool empty() const { return m_bySite.empty(); }
+
+    private:
+        std::vector<CallEdge> m_bySite;   // sorted by site
+        std::vector<CallEdge> m_byTarget; // sorted by target, then site
+    };
+}
@@ -0,0 +1,146 @@
+#include "StringXrefs.hpp"
+
+#include <algorithm>
+
+namespace analysis {
+    static bool isStringTarget(bin::Image const& image, uintptr_t target) {
+        auto section = image.getSectionAt(target);
+        return section && section->strings && image.readString(target).has_value();
+    }
+
+    static void decodeAArch64(std::vector<StringRef>& out, bin::Image const& image, bin::Section const& section) {
+        auto code = section.data;
+        for (size_t i = 0; i + 4 <= code.size(); i += 4) {
+            auto insn = *reinterpret_cast<uint32_t const*>(code.data() + i);
+
+            // adrp xd, #page
+            if ((insn & 0x9F000000) != 0x90000000) {
+                continue;
+            }
+
+            auto rd = insn & 0x1F;
+            auto immLo = (insn >> 29) & 0x3;
+            auto immHi = (insn >> 5) & 0x7FFFF;
+            auto imm = static_cast<int64_t>(static_cast<int32_t>(((immHi << 2) | immLo) << 11) >> 11) << 12;
+
+            auto site = section.address + i;
+            auto page = static_cast<uintptr_t>((site & ~uintptr_t{0xFFF}) + imm);
+
+            // the consumer is usually the next instruction, but the scheduler may put a few in between
+            for (size_t j = i + 4; j < i + 16 && j + 4 <= code.size(); j += 4) {
+                auto next = *reinterpret_cast<uint32_t const*>(code.data() + j);
+                auto rn = (next >> 5) & 0x1F;
+                auto imm12 = (next >> 10) & 0xFFF;
+
+                std::optional<uintptr_t> target;
+                if ((next & 0xFF800000) == 0x91000000 && rn == rd) {
+                    // add xd, xn, #imm{, lsl #12}
+                    auto shift = (next & (1u << 22)) ? 12 : 0;
+                    target = page + (static_cast<uintptr_t>(imm12) << shift);
+                } else if ((next & 0xFFC00000) == 0xF9400000 && rn == rd) {
+                    // ldr xt, [xn, #imm] - loads a pointer to the literal
+                    target = image.readPointer(page + imm12 * 8);
+                } else {
+                    continue;
+                }
+
+                if (target && isStringTarget(image, *target)) {
+                    out.emplace_back(static_cast<uint32_t>(*target), static_cast<uint32_t>(site));
+                }
+                break;
+            }
+        }
+    }
+
+    static void decodeAMD64(std::vector<StringRef>& out, bin::Image const& image, bin::Section const& section) {
+        auto code = section.data;
+        for (size_t i = 0; i + 7 <= code.size(); ++i) {
+            // lea r64, [rip + disp32]
+            if ((code[i] != 0x48 && code[i] != 0x4C) || code[i + 1] != 0x8D || (code[i + 2] & 0xC7) != 0x05) {
+                continue;
+            }
+
+            auto disp = *reinterpret_cast<int32_t const*>(code.data() + i + 3);
+            auto site = section.address + i;
+            auto target = static_cast<uintptr_t>(site + 7 + static_cast<intptr_t>(disp));
+
+            if (isStringTarget(image, target)) {
+                out.emplace_back(static_cast<uint32_t>(target), static_cast<uint32_t>(site));
+            }
+        }
+    }
+
+    StringXrefs StringXrefs::build(bin::Image const& image, Architecture arch) {
+        std::vector<StringRef> refs;
+        for (auto const& section : image.sections) {
+            if (!section.executable || section.data.empty()) {
+                continue;
+            }
+
+            switch (arch) {
+                case Architecture::AArch64:
+                    decodeAArch64(refs, image, section);
+                    break;
+                case Architecture::AMD64:
+                    decodeAMD64(refs, image, section);
+                    break;
+                case Architecture::Thumb:
+                    break; // Thumb-2 isn't decoded, armv7 binaries rely on symbols
+            }
+        }
+
+        return fromReferences(image, std::move(refs));
+    }
+
+    StringXrefs StringXrefs::fromReferences(bin::Image const& image, std::vector<StringRef> refs) {
+        StringXrefs xrefs;
+        xrefs.m_bySite = std::move(refs);
+        std::ranges::sort(xrefs.m_bySite, {}, &StringRef::site);
+        xrefs.m_byTarget = xrefs.m_bySite;
+        std::ranges::stable_sort(xrefs.m_byTarget, {}, &StringRef::target);
+
+        // only referenced literals can ever resolve, so there's no need to search the sections later
+        for (size_t i = 0; i < xrefs.m_byTarget.size(); ++i) {
+            auto target = xrefs.m_byTarget[i].target;
+            if (i > 0 && xrefs.m_byTarget[i - 1].target == target) {
+                continue;
+            }
+            if (auto value = image.readString(target)) {
+                xrefs.m_targetsByString[value.value()].push_back(target);
+            }
+        }
+
+        return xrefs;
+    }
+
+    std::span<StringRef const> StringXrefs::getReferences(uintptr_t target) const {
+        auto [first, last] = std::ranges::equal_range(m_byTarget, target, {}, &StringRef::target);
+        return {first, last};
+    }
+
+    std::span<StringRef const> StringXrefs::getReferencesInRange(uintptr_t start, uintptr_t end) const {
+        auto first = std::ranges::lower_bound(m_bySite, start, {}, &StringRef::site);
+        auto last = std::ranges::lower_bound(first, m_bySite.end(), end, {}, &StringRef::site);
+        return {first, last};
+    }
+
+    std::optional<uintptr_t> StringXrefs::resolve(bin::Image const& image, std::string_view value) const {
+        auto targets = m_targetsByString.find(value);
+        if (targets == m_targetsByString.end()) {
+            return std::nullopt;
+        }
+
+        std::optional<uintptr_t> function;
+        for (auto target : targets->second) {
+            for (auto const& ref : this->getReferences(target)) {
+                auto start = image.getFunctionStart(ref.site);
+                if (!start || (function && *function != *start)) {
+                    return std::nullopt;
+                }
+                function = start;
+            }
+        }
+
+        return function;
+    }
+}
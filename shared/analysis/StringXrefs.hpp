@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <bromascan.hpp>
+#include <binaries/Image.hpp>
+
+namespace analysis {
+    /// A code reference to a string literal, both addresses are relative to the image base
+    struct StringRef {
+        uint32_t target;
+        uint32_t site;
+    };
+
+    /// Index of every code reference into the string sections of an image.
+    /// Keeps views into the image data, so the binary must outlive the index.
+    class StringXrefs {
+    public:
+        StringXrefs() = default;
+
+        /// Decodes all executable sections in one linear pass.
+        /// AArch64: `ADRP` followed by `ADD`/`LDR` on the same register, amd64: RIP-relative `LEA`.
+        static StringXrefs build(bin::Image const& image, Architecture arch);
+
+        /// Rebuilds the lookup tables from previously decoded references, see `getAllReferences`.
+        static StringXrefs fromReferences(bin::Image const& image, std::vector<StringRef> refs);
+
+        /// Returns all references to the string at `target`.
+        [[nodiscard]] std::span<StringRef const> getReferences(uintptr_t target) const;
+
+        /// Returns all references with a site in range [start, end).
+        [[nodiscard]] std::span<StringRef const> getReferencesInRange(uintptr_t start, uintptr_t end) const;
+
+        /// Finds the single function referencing the string literal `value`.
+        /// Fails if the literal is referenced from more than one function or not at all.
+        [[nodiscard]] std::optional<uintptr_t> resolve(bin::Image const& image, std::string_view value) const;
+
+        /// Returns every reference, sorted by site.
+        [[nodiscard]] std::span<StringRef const> getAllReferences() const { return m_bySite; }
+
+        [[nodiscard]] size_t size() const { return m_bySite.size(); }
+        [[nodiscard]] bool empty() const { return m_bySite.empty(); }
+
+    private:
+        std::vector<StringRef> m_bySite;   // sorted by site
+        std::vector<StringRef> m_byTarget; // sorted by target, then site
+        std::unordered_map<std::string_view, std::vector<uint32_t>> m_targetsByString;
+    };
+}
@@ -0,0 +1,134 @@
+#include "Vtables.hpp"
+
+#include <algorithm>
+
+#include <binaries/PE.hpp>
+
+namespace analysis {
+    // walking limit in each direction, no GD class comes close to this
+    constexpr size_t maxVtableSlots = 1024;
+
+    static bool isCodeAddress(bin::Image const& image, uintptr_t address) {
+        auto section = image.getSectionAt(address);
+        return section && section->executable;
+    }
+
+    static bool isVirtualSlot(bin::Image const& image, uintptr_t slot) {
+        if (auto target = image.readPointer(slot)) {
+            return isCodeAddress(image, target.value());
+        }
+
+        // unresolved binds (__cxa_pure_virtual and friends) keep the table contiguous
+        switch (image.pointerFormat) {
+            case bin::PointerFormat::MachChained: {
+                auto raw = image.read<uint64_t>(slot);
+                return raw && (raw.value() & (1ull << 63));
+            }
+            case bin::PointerFormat::Relocated: {
+                auto relocation = image.findRelocation(slot);
+                return relocation && relocation->bind;
+            }
+            default:
+                return false;
+        }
+    }
+
+    VtableIndex VtableIndex::build(bin::Image const& image) {
+        std::vector<CodePointer> pointers;
+        auto addSlot = [&](uintptr_t slot) {
+            auto target = image.readPointer(slot);
+            if (target && isCodeAddress(image, target.value())) {
+                pointers.emplace_back(static_cast<uint32_t>(slot), static_cast<uint32_t>(target.value()));
+            }
+        };
+
+        switch (image.pointerFormat) {
+            case bin::PointerFormat::Absolute: {
+                for (auto slot : bin::pe::getPointerRelocations(image)) {
+                    auto section = image.getSectionAt(slot);
+                    if (section && !section->executable) {
+                        addSlot(slot);
+                    }
+                }
+                break;
+            }
+            case bin::PointerFormat::MachChained: {
+                for (auto const& section : image.sections) {
+                    if (section.name != "__const" || (section.segment != "__DATA" && section.segment != "__DATA_CONST")) {
+                        continue;
+                    }
+
+                    auto start = (section.address + 7) & ~uintptr_t{7};
+                    for (auto slot = start; slot + 8 <= section.address + section.data.size(); slot += 8) {
+                        addSlot(slot);
+                    }
+                }
+                break;
+            }
+            case bin::PointerFormat::Relocated: {
+                for (auto const& relocation : image.relocations) {
+                    auto section = image.getSectionAt(relocation.slot);
+                    if (!relocation.bind && section && !section->executable) {
+                        addSlot(relocation.slot);
+                    }
+                }
+                break;
+            }
+        }
+
+        return fromPointers(std::move(pointers));
+    }
+
+    VtableIndex VtableIndex::fromPointers(std::vector<CodePointer> pointers) {
+        VtableIndex index;
+        index.m_byTarget = std::move(pointers);
+        std::ranges::sort(index.m_byTarget, [](CodePointer const& a, CodePointer const& b) {
+            return a.target != b.target ? a.target < b.target : a.slot < b.slot;
+        });
+
+        return index;
+    }
+
+    std::span<CodePointer const> VtableIndex::getSlots(uintptr_t target) const {
+        auto [first, last] = std::ranges::equal_range(m_byTarget, target, {}, &CodePointer::target);
+        return {first, last};
+    }
+
+    std::optional<Vtable> VtableIndex::locate(bin::Image const& image, uintptr_t slot) {
+        if (!isVirtualSlot(image, slot)) {
+            return std::nullopt;
+        }
+
+        // MSVC puts the complete object locator and Itanium the typeinfo right before the
+        // first virtual function, both are data pointers so the walk stops on them
+        size_t stride = image.pointerSize;
+        auto start = slot;
+        for (size_t i = 0; i < maxVtableSlots && start >= stride && isVirtualSlot(image, start - stride); ++i) {
+            start -= stride;
+        }
+
+        auto end = slot + stride;
+        for (size_t i = 0; i < maxVtableSlots && isVirtualSlot(image, end); ++i) {
+            end += stride;
+        }
+
+        return Vtable{slot, start, end};
+    }
+
+    std::optional<uintptr_t> Vtable::read(bin::Image const& image, int32_t index) const {
+        auto slot = anchor + static_cast<intptr_t>(index) * image.pointerSize;
+        if (slot < start || slot >= end) {
+            return std::nullopt;
+        }
+        return image.readPointer(slot);
+    }
+
+    std::optional<int32_t> Vtable::find(bin::Image const& image, uintptr_t target) const {
+        for (auto slot = start; slot < end; slot += image.pointerSize) {
+            if (image.readPointer(slot) == target) {
+                return static_cast<int32_t>((static_cast<intptr_t>(slot) - static_cast<intptr_t>(anchor)) / image.pointerSize);
+            }
+        }
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <binaries/Image.hpp>
+
+namespace analysis {
+    /// A data slot holding a pointer into code, both addresses are relative to the image base
+    struct CodePointer {
+        uint32_t slot;
+        uint32_t target;
+    };
+
+    /// Virtual function table located around an anchor slot, slots are counted from the anchor
+    struct Vtable {
+        uintptr_t anchor;
+        uintptr_t start;
+        uintptr_t end;
+
+        /// Reads the function `index` slots away from the anchor
+        [[nodiscard]] std::optional<uintptr_t> read(bin::Image const& image, int32_t index) const;
+        /// Finds the first slot pointing to `target`, relative to the anchor
+        [[nodiscard]] std::optional<int32_t> find(bin::Image const& image, uintptr_t target) const;
+    };
+
+    /// Index of every code pointer stored in the constant data of an image.
+    /// PE uses the .reloc table, ELF its dynamic relocations, Mach-O scans every aligned word of the `__const` sections.
+    class VtableIndex {
+    public:
+        VtableIndex() = default;
+
+        static VtableIndex build(bin::Image const& image);
+
+        /// Rebuilds the index from previously collected pointers, see `getAllPointers`.
+        static VtableIndex fromPointers(std::vector<CodePointer> pointers);
+
+        /// Returns all data slots pointing to `target`.
+        [[nodiscard]] std::span<CodePointer const> getSlots(uintptr_t target) const;
+
+        /// Walks the surrounding slots of `slot` to find the bounds of its vtable.
+        static std::optional<Vtable> locate(bin::Image const& image, uintptr_t slot);
+
+        /// Returns every code pointer, sorted by target.
+        [[nodiscard]] std::span<CodePointer const> getAllPointers() const { return m_byTarget; }
+
+        [[nodiscard]] size_t size() const { return m_byTarget.size(); }
+        [[nodiscard]] bool empty() const { return m_byTarget.empty(); }
+
+    private:
+        std::vector<CodePointer> m_byTarget; // sorted by target, then slot
+    };
+}
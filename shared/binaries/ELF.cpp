@@ -0,0 +1,334 @@
+#include "ELF.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define BROMASCAN_HAS_CXXABI
+#endif
+
+namespace bin::elf {
+    struct Elf32 {
+        using Ehdr = Elf32_Ehdr;
+        using Shdr = Elf32_Shdr;
+        using Sym = Elf32_Sym;
+        using Rel = Elf32_Rel;
+        using Rela = Elf32_Rela;
+        using Word = uint32_t;
+
+        static uint32_t getSymbol(uint32_t info) { return info >> 8; }
+        static uint32_t getType(uint32_t info) { return info & 0xFF; }
+    };
+
+    struct Elf64 {
+        using Ehdr = Elf64_Ehdr;
+        using Shdr = Elf64_Shdr;
+        using Sym = Elf64_Sym;
+        using Rel = Elf64_Rel;
+        using Rela = Elf64_Rela;
+        using Word = uint64_t;
+
+        static uint32_t getSymbol(uint64_t info) { return static_cast<uint32_t>(info >> 32); }
+        static uint32_t getType(uint64_t info) { return static_cast<uint32_t>(info); }
+    };
+
+    enum class RelocationKind {
+        Other,
+        Relative, // image base + addend
+        Absolute, // symbol + addend
+    };
+
+    static RelocationKind getRelocationKind(uint16_t machine, uint32_t type) {
+        switch (machine) {
+            case EM_386:
+            case EM_X86_64:
+                // R_386_RELATIVE / R_X86_64_RELATIVE, R_386_32 / R_X86_64_64
+                return type == 8 ? RelocationKind::Relative : type == 1 ? RelocationKind::Absolute : RelocationKind::Other;
+            case EM_ARM:
+                // R_ARM_RELATIVE, R_ARM_ABS32
+                return type == 23 ? RelocationKind::Relative : type == 2 ? RelocationKind::Absolute : RelocationKind::Other;
+            case EM_AARCH64:
+                // R_AARCH64_RELATIVE, R_AARCH64_ABS64
+                return type == 1027 ? RelocationKind::Relative : type == 257 ? RelocationKind::Absolute : RelocationKind::Other;
+            default:
+                return RelocationKind::Other;
+        }
+    }
+
+    static std::string_view readName(std::span<uint8_t const> table, size_t offset) {
+        if (offset >= table.size()) {
+            return {};
+        }
+
+        auto str = reinterpret_cast<char const*>(table.data() + offset);
+        return {str, strnlen(str, table.size() - offset)};
+    }
+
+    template <typename Shdr>
+    static std::span<uint8_t const> getSectionData(std::span<uint8_t const> binaryData, Shdr const& header) {
+        if (header.sh_type == SHT_NOBITS || header.sh_offset + header.sh_size > binaryData.size()) {
+            return {};
+        }
+        return binaryData.subspan(header.sh_offset, header.sh_size);
+    }
+
+    template <typename Traits>
+    static geode::Result<std::span<typename Traits::Shdr const>> getSectionHeaders(std::span<uint8_t const> binaryData) {
+        using Ehdr = typename Traits::Ehdr;
+        using Shdr = typename Traits::Shdr;
+
+        if (binaryData.size() < sizeof(Ehdr)) {
+            return geode::Err("Invalid ELF file: too small for ELF header");
+        }
+
+        auto header = reinterpret_cast<Ehdr const*>(binaryData.data());
+        if (header->e_shentsize != sizeof(Shdr)) {
+            return geode::Err("Invalid ELF file: unexpected section header size");
+        }
+
+        if (header->e_shoff + header->e_shnum * sizeof(Shdr) > binaryData.size()) {
+            return geode::Err("Invalid ELF file: too small for section headers");
+        }
+
+        return geode::Ok(std::span(
+            reinterpret_cast<Shdr const*>(binaryData.data() + header->e_shoff),
+            header->e_shnum
+        ));
+    }
+
+    template <typename Traits>
+    static geode::Result<std::vector<Symbol>> collectSymbols(std::span<uint8_t const> binaryData) {
+        using Sym = typename Traits::Sym;
+        GEODE_UNWRAP_INTO(auto headers, getSectionHeaders<Traits>(binaryData));
+
+        std::vector<Symbol> symbols;
+        for (auto const& header : headers) {
+            if ((header.sh_type != SHT_SYMTAB && header.sh_type != SHT_DYNSYM) || header.sh_link >= headers.size()) {
+                continue;
+            }
+
+            auto names = getSectionData(binaryData, headers[header.sh_link]);
+            auto data = getSectionData(binaryData, header);
+            auto entries = reinterpret_cast<Sym const*>(data.data());
+            for (size_t i = 0; i < data.size() / sizeof(Sym); ++i) {
+                auto const& sym = entries[i];
+                if ((sym.st_info & 0xF) != STT_FUNC || sym.st_shndx == SHN_UNDEF || sym.st_value == 0) {
+                    continue;
+                }
+
+                auto name = readName(names, sym.st_name);
+                if (name.empty()) {
+                    continue;
+                }
+
+                // the lowest bit marks Thumb code on armv7
+                symbols.emplace_back(name, static_cast<uintptr_t>(sym.st_value) & ~uintptr_t{1});
+            }
+        }
+
+        return geode::Ok(std::move(symbols));
+    }
+
+    template <typename Traits, typename Entry>
+    static void collectRelocations(
+        Image& image,
+        std::span<uint8_t const> binaryData,
+        std::span<typename Traits::Shdr const> headers,
+        typename Traits::Shdr const& header,
+        uint16_t machine
+    ) {
+        using Sym = typename Traits::Sym;
+        using Word = typename Traits::Word;
+        constexpr bool hasAddend = requires(Entry entry) { entry.r_addend; };
+
+        std::span<uint8_t const> symbols;
+        if (header.sh_link < headers.size()) {
+            symbols = getSectionData(binaryData, headers[header.sh_link]);
+        }
+
+        auto data = getSectionData(binaryData, header);
+        auto entries = reinterpret_cast<Entry const*>(data.data());
+        for (size_t i = 0; i < data.size() / sizeof(Entry); ++i) {
+            auto const& entry = entries[i];
+            auto kind = getRelocationKind(machine, Traits::getType(entry.r_info));
+            if (kind == RelocationKind::Other) {
+                continue;
+            }
+
+            // REL keeps the addend in the slot itself
+            auto slot = static_cast<uintptr_t>(entry.r_offset);
+            uint64_t addend = 0;
+            if constexpr (hasAddend) {
+                addend = static_cast<uint64_t>(entry.r_addend);
+            } else if (auto value = image.read<Word>(slot)) {
+                addend = value.value();
+            } else {
+                continue;
+            }
+
+            Relocation relocation{slot, static_cast<uintptr_t>(addend)};
+            if (kind == RelocationKind::Absolute) {
+                auto index = Traits::getSymbol(entry.r_info);
+                if ((index + 1) * sizeof(Sym) > symbols.size()) {
+                    continue;
+                }
+
+                auto const& symbol = reinterpret_cast<Sym const*>(symbols.data())[index];
+                if (symbol.st_shndx == SHN_UNDEF) {
+                    relocation.target = 0;
+                    relocation.bind = true;
+                } else {
+                    relocation.target = static_cast<uintptr_t>(symbol.st_value + addend);
+                }
+            }
+
+            // the lowest bit marks Thumb code on armv7
+            if (machine == EM_ARM && !relocation.bind) {
+                auto section = image.getSectionAt(relocation.target & ~uintptr_t{1});
+                if (section && section->executable) {
+                    relocation.target &= ~uintptr_t{1};
+                }
+            }
+
+            image.relocations.push_back(relocation);
+        }
+    }
+
+    template <typename Traits>
+    static geode::Result<Image> parseImage(std::span<uint8_t const> binaryData, SymbolTable const& symbols) {
+        GEODE_UNWRAP_INTO(auto headers, getSectionHeaders<Traits>(binaryData));
+
+        auto header = reinterpret_cast<typename Traits::Ehdr const*>(binaryData.data());
+        if (header->e_shstrndx >= headers.size()) {
+            return geode::Err("Invalid ELF file: missing section name table");
+        }
+
+        Image image;
+        image.pointerFormat = PointerFormat::Relocated; // shared objects are linked at 0
+        image.pointerSize = sizeof(typename Traits::Word);
+
+        auto names = getSectionData(binaryData, headers[header->e_shstrndx]);
+        for (auto const& sectionHeader : headers) {
+            if (sectionHeader.sh_type == 0) {
+                continue;
+            }
+
+            auto& section = image.sections.emplace_back();
+            section.name = readName(names, sectionHeader.sh_name);
+            section.address = sectionHeader.sh_addr;
+            section.data = getSectionData(binaryData, sectionHeader);
+            section.executable = (sectionHeader.sh_flags & SHF_EXECINSTR) != 0;
+            section.strings = (sectionHeader.sh_flags & SHF_STRINGS) != 0;
+        }
+
+        // vtables and other pointers in shared objects only exist as dynamic relocations
+        for (auto const& sectionHeader : headers) {
+            if (sectionHeader.sh_type == SHT_RELA) {
+                collectRelocations<Traits, typename Traits::Rela>(image, binaryData, headers, sectionHeader, header->e_machine);
+            } else if (sectionHeader.sh_type == SHT_REL) {
+                collectRelocations<Traits, typename Traits::Rel>(image, binaryData, headers, sectionHeader, header->e_machine);
+            }
+        }
+
+        std::ranges::sort(image.relocations, {}, &Relocation::slot);
+        auto [firstRelocation, lastRelocation] = std::ranges::unique(image.relocations, {}, &Relocation::slot);
+        image.relocations.erase(firstRelocation, lastRelocation);
+
+        // the table is sorted by address already
+        image.functionStarts.reserve(symbols.size());
+        for (auto const& symbol : symbols.getSymbols()) {
+            if (image.functionStarts.empty() || image.functionStarts.back() != symbol.address) {
+                image.functionStarts.push_back(symbol.address);
+            }
+        }
+
+        return geode::Ok(std::move(image));
+    }
+
+    geode::Result<SymbolTable> SymbolTable::build(std::span<uint8_t const> binaryData) {
+        if (!isELF(binaryData)) {
+            return geode::Err("Invalid ELF file: missing ELF magic");
+        }
+
+        SymbolTable table;
+        if (isELF64(binaryData)) {
+            GEODE_UNWRAP_INTO(table.m_byAddress, collectSymbols<Elf64>(binaryData));
+        } else {
+            GEODE_UNWRAP_INTO(table.m_byAddress, collectSymbols<Elf32>(binaryData));
+        }
+
+        std::ranges::sort(table.m_byAddress, {}, &Symbol::address);
+        table.m_byName.reserve(table.m_byAddress.size());
+        for (auto const& symbol : table.m_byAddress) {
+            table.m_byName.emplace(symbol.name, symbol.address);
+        }
+
+        return geode::Ok(std::move(table));
+    }
+
+    std::optional<uintptr_t> SymbolTable::find(std::string_view mangledName) const {
+        auto it = m_byName.find(mangledName);
+        if (it == m_byName.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::span<Symbol const> SymbolTable::getSymbolsAt(uintptr_t address) const {
+        auto [first, last] = std::ranges::equal_range(m_byAddress, address, {}, &Symbol::address);
+        return {first, last};
+    }
+
+    geode::Result<Image> getImage(std::span<uint8_t const> binaryData, SymbolTable const& symbols) {
+        if (!isELF(binaryData)) {
+            return geode::Err("Invalid ELF file: missing ELF magic");
+        }
+
+        if (isELF64(binaryData)) {
+            return parseImage<Elf64>(binaryData, symbols);
+        }
+        return parseImage<Elf32>(binaryData, symbols);
+    }
+
+    geode::Result<std::string> demangle(std::string_view mangledName) {
+#ifdef BROMASCAN_HAS_CXXABI
+        std::string name(mangledName);
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+        if (status != 0 || !demangled) {
+            std::free(demangled);
+            return geode::Err(fmt::format("Failed to demangle {}", mangledName));
+        }
+
+        name = demangled;
+        std::free(demangled);
+        return geode::Ok(std::move(name));
+#else
+        return geode::Err(fmt::format("Failed to demangle {}: no demangler in this build", mangledName));
+#endif
+    }
+
+    bool canDemangle() {
+#ifdef BROMASCAN_HAS_CXXABI
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool isELF(std::span<uint8_t const> binaryData) {
+        if (binaryData.size() < 16) {
+            return false;
+        }
+
+        auto magic = *reinterpret_cast<uint32_t const*>(binaryData.data());
+        return magic == ELF_MAGIC;
+    }
+
+    bool isELF64(std::span<uint8_t const> binaryData) {
+        return isELF(binaryData) && binaryData[4] == ELFCLASS64;
+    }
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <Geode/Result.hpp>
+
+#include "Image.hpp"
+
+namespace bin::elf {
+    constexpr uint32_t ELF_MAGIC = 0x464C457F; // "\x7FELF"
+    constexpr uint8_t ELFCLASS32 = 1;
+    constexpr uint8_t ELFCLASS64 = 2;
+
+    constexpr uint16_t EM_386 = 3;
+    constexpr uint16_t EM_ARM = 40;
+    constexpr uint16_t EM_X86_64 = 62;
+    constexpr uint16_t EM_AARCH64 = 183;
+
+    constexpr uint32_t SHT_SYMTAB = 2;
+    constexpr uint32_t SHT_RELA = 4;
+    constexpr uint32_t SHT_NOBITS = 8;
+    constexpr uint32_t SHT_REL = 9;
+    constexpr uint32_t SHT_DYNSYM = 11;
+    constexpr uint32_t SHF_EXECINSTR = 0x4;
+    constexpr uint32_t SHF_STRINGS = 0x20;
+    constexpr uint8_t STT_FUNC = 2;
+    constexpr uint16_t SHN_UNDEF = 0;
+
+    struct Elf32_Ehdr {
+        uint8_t e_ident[16];
+        uint16_t e_type;
+        uint16_t e_machine;
+        uint32_t e_version;
+        uint32_t e_entry;
+        uint32_t e_phoff;
+        uint32_t e_shoff;
+        uint32_t e_flags;
+        uint16_t e_ehsize;
+        uint16_t e_phentsize;
+        uint16_t e_phnum;
+        uint16_t e_shentsize;
+        uint16_t e_shnum;
+        uint16_t e_shstrndx;
+    };
+
+    struct Elf64_Ehdr {
+        uint8_t e_ident[16];
+        uint16_t e_type;
+        uint16_t e_machine;
+        uint32_t e_version;
+        uint64_t e_entry;
+        uint64_t e_phoff;
+        uint64_t e_shoff;
+        uint32_t e_flags;
+        uint16_t e_ehsize;
+        uint16_t e_phentsize;
+        uint16_t e_phnum;
+        uint16_t e_shentsize;
+        uint16_t e_shnum;
+        uint16_t e_shstrndx;
+    };
+
+    struct Elf32_Shdr {
+        uint32_t sh_name;
+        uint32_t sh_type;
+        uint32_t sh_flags;
+        uint32_t sh_addr;
+        uint32_t sh_offset;
+        uint32_t sh_size;
+        uint32_t sh_link;
+        uint32_t sh_info;
+        uint32_t sh_addralign;
+        uint32_t sh_entsize;
+    };
+
+    struct Elf64_Shdr {
+        uint32_t sh_name;
+        uint32_t sh_type;
+        uint64_t sh_flags;
+        uint64_t sh_addr;
+        uint64_t sh_offset;
+        uint64_t sh_size;
+        uint32_t sh_link;
+        uint32_t sh_info;
+        uint64_t sh_addralign;
+        uint64_t sh_entsize;
+    };
+
+    struct Elf32_Sym {
+        uint32_t st_name;
+        uint32_t st_value;
+        uint32_t st_size;
+        uint8_t st_info;
+        uint8_t st_other;
+        uint16_t st_shndx;
+    };
+
+    struct Elf64_Sym {
+        uint32_t st_name;
+        uint8_t st_info;
+        uint8_t st_other;
+        uint16_t st_shndx;
+        uint64_t st_value;
+        uint64_t st_size;
+    };
+
+    struct Elf32_Rel {
+        uint32_t r_offset;
+        uint32_t r_info;
+    };
+
+    struct Elf32_Rela {
+        uint32_t r_offset;
+        uint32_t r_info;
+        int32_t r_addend;
+    };
+
+    struct Elf64_Rel {
+        uint64_t r_offset;
+        uint64_t r_info;
+    };
+
+    struct Elf64_Rela {
+        uint64_t r_offset;
+        uint64_t r_info;
+        int64_t r_addend;
+    };
+
+    struct Symbol {
+        std::string_view name; // mangled
+        uintptr_t address;
+    };
+
+    /// Function symbols from .dynsym and .symtab, indexed by mangled name and by address.
+    /// Keeps views into the binary, so it must outlive the table.
+    class SymbolTable {
+    public:
+        SymbolTable() = default;
+
+        static geode::Result<SymbolTable> build(std::span<uint8_t const> binaryData);
+
+        [[nodiscard]] std::optional<uintptr_t> find(std::string_view mangledName) const;
+        [[nodiscard]] std::span<Symbol const> getSymbolsAt(uintptr_t address) const;
+        /// Every symbol, sorted by address
+        [[nodiscard]] std::span<Symbol const> getSymbols() const { return m_byAddress; }
+
+        [[nodiscard]] size_t size() const { return m_byAddress.size(); }
+        [[nodiscard]] bool empty() const { return m_byAddress.empty(); }
+
+    private:
+        std::vector<Symbol> m_byAddress; // sorted by address
+        std::unordered_map<std::string_view, uintptr_t> m_byName;
+    };
+
+    /// Parses the section table and the dynamic relocations, using `symbols` as the function starts table
+    geode::Result<Image> getImage(std::span<uint8_t const> binaryData, SymbolTable const& symbols);
+
+    /// Demangles an Itanium C++ symbol name
+    geode::Result<std::string> demangle(std::string_view mangledName);
+    /// Whether this build ships a demangler, `demangle` always fails otherwise
+    bool canDemangle();
+
+    bool isELF(std::span<uint8_t const> binaryData);
+    bool isELF64(std::span<uint8_t const> binaryData);
+}
@@ -0,0 +1,112 @@
+#include "Image.hpp"
+
+#include <algorithm>
+
+namespace bin {
+    Section const* Image::findSection(std::string_view segment, std::string_view name) const {
+        auto it = std::ranges::find_if(sections, [&](Section const& section) {
+            return section.segment == segment && section.name == name;
+        });
+        return it != sections.end() ? &*it : nullptr;
+    }
+
+    Section const* Image::getSectionAt(uintptr_t address) const {
+        auto it = std::ranges::find_if(sections, [&](Section const& section) {
+            return address >= section.address && address - section.address < section.data.size();
+        });
+        return it != sections.end() ? &*it : nullptr;
+    }
+
+    std::optional<uintptr_t> Image::getFunctionStart(uintptr_t address) const {
+        auto it = std::ranges::upper_bound(functionStarts, address);
+        if (it == functionStarts.begin()) {
+            return std::nullopt;
+        }
+        return *std::prev(it);
+    }
+
+    std::optional<uintptr_t> Image::getNextFunctionStart(uintptr_t address) const {
+        auto it = std::ranges::upper_bound(functionStarts, address);
+        if (it == functionStarts.end()) {
+            return std::nullopt;
+        }
+        return *it;
+    }
+
+    std::optional<std::string_view> Image::readString(uintptr_t address) const {
+        auto section = this->getSectionAt(address);
+        if (!section) {
+            return std::nullopt;
+        }
+
+        auto data = section->data.subspan(address - section->address);
+        for (size_t i = 0; i < data.size(); ++i) {
+            auto c = data[i];
+            if (c == 0) {
+                if (i == 0) {
+                    return std::nullopt;
+                }
+                return std::string_view(reinterpret_cast<char const*>(data.data()), i);
+            }
+
+            if ((c < 0x20 || c > 0x7E) && c != '\t' && c != '\n' && c != '\r') {
+                return std::nullopt;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    Relocation const* Image::findRelocation(uintptr_t slot) const {
+        auto it = std::ranges::lower_bound(relocations, slot, {}, &Relocation::slot);
+        return it != relocations.end() && it->slot == slot ? &*it : nullptr;
+    }
+
+    std::optional<uintptr_t> Image::readPointer(uintptr_t address) const {
+        // position independent code can't hold a plain pointer, so the relocation is all there is
+        if (pointerFormat == PointerFormat::Relocated) {
+            auto relocation = this->findRelocation(address);
+            if (!relocation || relocation->bind || relocation->target > UINT32_MAX) {
+                return std::nullopt;
+            }
+            return relocation->target;
+        }
+
+        auto raw = this->read<uint64_t>(address);
+        if (!raw) {
+            return std::nullopt;
+        }
+
+        auto value = raw.value();
+        switch (pointerFormat) {
+            case PointerFormat::Absolute: {
+                if (value < imageBase || value - imageBase > UINT32_MAX) {
+                    return std::nullopt;
+                }
+                return value - imageBase;
+            }
+            case PointerFormat::MachChained: {
+                // bind entries point outside the image
+                if (value & (1ull << 63)) {
+                    return std::nullopt;
+                }
+
+                // DYLD_CHAINED_PTR_64 keeps the target in the low 36 bits, which
+                // also covers plain vmaddr pointers of non-chained binaries
+                uint64_t target = value & 0xF'FFFF'FFFFull;
+                if (target >= imageBase) {
+                    target -= imageBase;
+                }
+                if (target > UINT32_MAX) {
+                    return std::nullopt;
+                }
+                return target;
+            }
+            case PointerFormat::Relocated: {
+                break;
+            }
+        }
+
+        return std::nullopt;
+    }
+}
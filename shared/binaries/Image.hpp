@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace bin {
+    struct Section {
+        std::string_view segment; // empty for PE
+        std::string_view name;
+        uintptr_t address = 0; // relative to image base
+        std::span<uint8_t const> data;
+        bool executable = false;
+        bool strings = false; // may hold C string literals
+    };
+
+    enum class PointerFormat {
+        Absolute,     // plain image base + address (PE)
+        MachChained,  // raw vmaddr or dyld chained fixup rebase (Mach-O)
+        Relocated,    // only slots covered by a dynamic relocation (ELF)
+    };
+
+    /// A data slot rebased or bound by the loader
+    struct Relocation {
+        uintptr_t slot;
+        uintptr_t target; // 0 for binds
+        bool bind = false; // resolved to an imported symbol at load time
+    };
+
+    /// Section-level view over a loaded binary, all addresses are relative to the image base.
+    struct Image {
+        uint64_t imageBase = 0;
+        PointerFormat pointerFormat = PointerFormat::Absolute;
+        uint8_t pointerSize = 8;
+        std::vector<Section> sections;
+        std::vector<uintptr_t> functionStarts; // sorted, may be empty
+        std::vector<Relocation> relocations; // sorted by slot, only filled for `PointerFormat::Relocated`
+
+        [[nodiscard]] Section const* findSection(std::string_view segment, std::string_view name) const;
+        [[nodiscard]] Section const* getSectionAt(uintptr_t address) const;
+
+        /// Start of the function containing `address`, based on the function starts table
+        [[nodiscard]] std::optional<uintptr_t> getFunctionStart(uintptr_t address) const;
+        /// Start of the first function after `address`, based on the function starts table
+        [[nodiscard]] std::optional<uintptr_t> getNextFunctionStart(uintptr_t address) const;
+
+        /// Reads a NUL-terminated printable string located at `address`
+        [[nodiscard]] std::optional<std::string_view> readString(uintptr_t address) const;
+        /// Dynamic relocation applied to `slot`, if any
+        [[nodiscard]] Relocation const* findRelocation(uintptr_t slot) const;
+        /// Reads and rebases a pointer-sized value stored at `address`
+        [[nodiscard]] std::optional<uintptr_t> readPointer(uintptr_t address) const;
+
+        template <typename T>
+        [[nodiscard]] std::optional<T> read(uintptr_t address) const {
+            auto section = this->getSectionAt(address);
+            if (!section || address - section->address + sizeof(T) > section->data.size()) {
+                return std::nullopt;
+            }
+            return *reinterpret_cast<T const*>(section->data.data() + (address - section->address));
+        }
+    };
+}
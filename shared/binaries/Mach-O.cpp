@@ -1,35 +1,146 @@
 #include "Mach-O.hpp"
 
+#include <cstring>
+
 namespace bin::mach {
-    geode::Result<std::span<uint8_t const>> getSegment(std::span<uint8_t const> binaryData, CPUType type) {
-        auto magic = *reinterpret_cast<uint32_t const*>(binaryData.data());
+    static std::string_view fixedString(char const (&str)[16]) {
+        return {str, strnlen(str, sizeof(str))};
+    }
+
+    geode::Result<std::span<uint8_t const>> getSlice(std::span<uint8_t const> binaryData, CPUType type) {
+        if (isMachO64(binaryData)) {
+            return geode::Ok(binaryData);
+        }
+
+        if (!isFatBinary(binaryData)) {
+            return geode::Err("Unsupported Mach-O format");
+        }
+
+        auto fatHeader = reinterpret_cast<fat_header const*>(binaryData.data());
+        auto fatArches = reinterpret_cast<fat_arch const*>(binaryData.data() + sizeof(fat_header));
+        if (sizeof(fat_header) + fatHeader->get_nfat_arch() * sizeof(fat_arch) > binaryData.size()) {
+            return geode::Err("Invalid fat binary header size");
+        }
+
+        for (uint32_t i = 0; i < fatHeader->get_nfat_arch(); ++i) {
+            if (fatArches[i].get_cputype() == static_cast<cpu_type_t>(type)) {
+                size_t offset = fatArches[i].get_offset();
+                size_t size = fatArches[i].get_size();
+                if (offset + size > binaryData.size()) {
+                    return geode::Err("Invalid fat binary architecture size");
+                }
+                return geode::Ok(binaryData.subspan(offset, size));
+            }
+        }
+
+        return geode::Err("Specified CPU type not found in fat binary");
+    }
+
+    geode::Result<Image> getImage(std::span<uint8_t const> binaryData, CPUType type) {
+        GEODE_UNWRAP_INTO(auto slice, getSlice(binaryData, type));
+        if (!isMachO64(slice)) {
+            return geode::Err("Mach-O slice is not a 64-bit image");
+        }
+
+        auto header = reinterpret_cast<mach_header_64 const*>(slice.data());
+        size_t commandsEnd = sizeof(mach_header_64) + header->sizeofcmds;
+        if (commandsEnd > slice.size()) {
+            return geode::Err("Invalid Mach-O 64-bit header size");
+        }
+
+        Image image;
+        image.pointerFormat = PointerFormat::MachChained;
+        std::span<uint8_t const> functionStarts;
+
+        size_t offset = sizeof(mach_header_64);
+        for (uint32_t i = 0; i < header->ncmds; ++i) {
+            if (offset + sizeof(load_command) > commandsEnd) {
+                return geode::Err("Truncated Mach-O load command");
+            }
 
-        if (magic == MH_MAGIC_64) {
-            auto header64 = reinterpret_cast<mach_header_64 const*>(binaryData.data());
-            size_t offset = sizeof(mach_header_64) + header64->sizeofcmds;
-            if (offset > binaryData.size()) {
-                return geode::Err("Invalid Mach-O 64-bit header size");
+            auto command = reinterpret_cast<load_command const*>(slice.data() + offset);
+            if (command->cmdsize < sizeof(load_command) || offset + command->cmdsize > commandsEnd) {
+                return geode::Err("Invalid Mach-O load command size");
             }
-            return geode::Ok(binaryData.subspan(offset));
-        }
-
-        if (magic == FAT_MAGIC) {
-            auto fatHeader = reinterpret_cast<fat_header const*>(binaryData.data());
-            auto fatArches = reinterpret_cast<fat_arch const*>(binaryData.data() + sizeof(fat_header));
-            for (uint32_t i = 0; i < fatHeader->get_nfat_arch(); ++i) {
-                if (fatArches[i].get_cputype() == static_cast<cpu_type_t>(type)) {
-                    size_t offset = fatArches[i].get_offset();
-                    size_t size = fatArches[i].get_size();
-                    if (offset + size > binaryData.size()) {
-                        return geode::Err("Invalid fat binary architecture size");
+
+            if (command->cmd == LC_SEGMENT_64) {
+                auto segment = reinterpret_cast<segment_command_64 const*>(command);
+                if (command->cmdsize < sizeof(segment_command_64) + segment->nsects * sizeof(section_64)) {
+                    return geode::Err("Invalid Mach-O segment command size");
+                }
+
+                if (fixedString(segment->segname) == "__TEXT") {
+                    image.imageBase = segment->vmaddr;
+                }
+
+                auto sections = reinterpret_cast<section_64 const*>(segment + 1);
+                for (uint32_t j = 0; j < segment->nsects; ++j) {
+                    auto const& sect = sections[j];
+                    auto sectionType = sect.flags & SECTION_TYPE;
+
+                    auto& section = image.sections.emplace_back();
+                    section.segment = fixedString(sect.segname);
+                    section.name = fixedString(sect.sectname);
+                    section.address = sect.addr; // rebased below, __TEXT is not always the first segment
+                    section.executable = (sect.flags & (S_ATTR_PURE_INSTRUCTIONS | S_ATTR_SOME_INSTRUCTIONS)) != 0;
+                    section.strings = sectionType == S_CSTRING_LITERALS;
+
+                    bool zeroFill = sectionType == S_ZEROFILL ||
+                                    sectionType == S_GB_ZEROFILL ||
+                                    sectionType == S_THREAD_LOCAL_ZEROFILL;
+                    if (zeroFill || sect.offset == 0) {
+                        continue;
+                    }
+
+                    if (sect.offset + sect.size > slice.size()) {
+                        return geode::Err("Mach-O section out of bounds");
                     }
-                    return geode::Ok(binaryData.subspan(offset, size));
+                    section.data = slice.subspan(sect.offset, sect.size);
                 }
+            } else if (command->cmd == LC_FUNCTION_STARTS) {
+                auto linkedit = reinterpret_cast<linkedit_data_command const*>(command);
+                if (static_cast<size_t>(linkedit->dataoff) + linkedit->datasize > slice.size()) {
+                    return geode::Err("Mach-O function starts out of bounds");
+                }
+                functionStarts = slice.subspan(linkedit->dataoff, linkedit->datasize);
             }
-            return geode::Err("Specified CPU type not found in fat binary");
+
+            offset += command->cmdsize;
         }
 
-        return geode::Err("Unsupported Mach-O format");
+        for (auto& section : image.sections) {
+            section.address -= image.imageBase;
+        }
+
+        // ULEB128 deltas, starting from the beginning of __TEXT and terminated by 0
+        uintptr_t address = 0;
+        for (size_t i = 0; i < functionStarts.size();) {
+            uint64_t delta = 0;
+            uint32_t shift = 0;
+            uint8_t byte;
+            do {
+                byte = functionStarts[i++];
+                delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+            } while ((byte & 0x80) && i < functionStarts.size());
+
+            if (delta == 0) {
+                break;
+            }
+
+            address += delta;
+            image.functionStarts.push_back(address);
+        }
+
+        return geode::Ok(std::move(image));
+    }
+
+    geode::Result<Section> getTextSection(Image const& image) {
+        auto text = image.findSection("__TEXT", "__text");
+        if (!text || text->data.empty()) {
+            return geode::Err("Mach-O image has no __TEXT,__text section");
+        }
+        return geode::Ok(*text);
     }
 
     bool isFatBinary(std::span<uint8_t const> binaryData) {
@@ -5,6 +5,8 @@
 #include <span>
 #include <Geode/Result.hpp>
 
+#include "Image.hpp"
+
 namespace bin::mach {
     using cpu_type_t = uint32_t;
     using cpu_subtype_t = uint32_t;
@@ -80,18 +82,81 @@ namespace bin::mach {
         GEN_GETTER(uint32_t, align)
     };
 
+    #undef GEN_GETTER
+
+    // load commands are stored in the slice's own (little) endian, read them as-is
+    constexpr uint32_t LC_SEGMENT_64 = 0x19;
+    constexpr uint32_t LC_FUNCTION_STARTS = 0x26;
+
+    constexpr uint32_t SECTION_TYPE = 0x000000FF;
+    constexpr uint32_t S_ZEROFILL = 0x1;
+    constexpr uint32_t S_CSTRING_LITERALS = 0x2;
+    constexpr uint32_t S_GB_ZEROFILL = 0xC;
+    constexpr uint32_t S_THREAD_LOCAL_ZEROFILL = 0x12;
+    constexpr uint32_t S_ATTR_PURE_INSTRUCTIONS = 0x80000000;
+    constexpr uint32_t S_ATTR_SOME_INSTRUCTIONS = 0x00000400;
+
+    struct load_command {
+        uint32_t cmd;
+        uint32_t cmdsize;
+    };
+
+    struct segment_command_64 {
+        uint32_t cmd; // LC_SEGMENT_64
+        uint32_t cmdsize;
+        char segname[16];
+        uint64_t vmaddr;
+        uint64_t vmsize;
+        uint64_t fileoff;
+        uint64_t filesize;
+        uint32_t maxprot;
+        uint32_t initprot;
+        uint32_t nsects;
+        uint32_t flags;
+    };
+
+    struct section_64 {
+        char sectname[16];
+        char segname[16];
+        uint64_t addr;
+        uint64_t size;
+        uint32_t offset;
+        uint32_t align;
+        uint32_t reloff;
+        uint32_t nreloc;
+        uint32_t flags;
+        uint32_t reserved1;
+        uint32_t reserved2;
+        uint32_t reserved3;
+    };
+
+    struct linkedit_data_command {
+        uint32_t cmd; // LC_FUNCTION_STARTS, LC_DYLD_CHAINED_FIXUPS, ...
+        uint32_t cmdsize;
+        uint32_t dataoff;
+        uint32_t datasize;
+    };
+
     enum class CPUType : cpu_type_t {
         X86_64 = 0x01000007,
         ARM64 = 0x0100000C,
     };
 
-    geode::Result<std::span<uint8_t const>> getSegment(
+    /// Returns the whole Mach-O image for the given CPU type (fat slice or the thin binary itself)
+    geode::Result<std::span<uint8_t const>> getSlice(
         std::span<uint8_t const> binaryData,
         CPUType type
     );
 
+    /// Parses segments, sections and LC_FUNCTION_STARTS of the image for the given CPU type
+    geode::Result<Image> getImage(
+        std::span<uint8_t const> binaryData,
+        CPUType type
+    );
+
+    /// Returns the `__TEXT,__text` section of a parsed image, the only bytes worth scanning for code
+    geode::Result<Section> getTextSection(Image const& image);
+
     bool isFatBinary(std::span<uint8_t const> binaryData);
     bool isMachO64(std::span<uint8_t const> binaryData);
-
-    #undef GEN_GETTER
 }
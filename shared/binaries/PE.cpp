@@ -1,4 +1,6 @@
 #include "PE.hpp"
+#include <algorithm>
+#include <cstring>
 #include <fmt/format.h>
 
 namespace bin::pe {
@@ -48,6 +50,106 @@ namespace bin::pe {
         return geode::Err("PE file has no .text section");
     }
 
+    geode::Result<Image> getImage(std::span<uint8_t const> binaryData) {
+        if (!isPE64(binaryData)) {
+            return geode::Err("Invalid PE file: missing PE signature");
+        }
+
+        auto* dosHeader = reinterpret_cast<DOSHeader const*>(binaryData.data());
+        size_t fileHeaderOffset = dosHeader->e_lfanew + sizeof(uint32_t);
+        if (fileHeaderOffset + sizeof(FileHeader) > binaryData.size()) {
+            return geode::Err("Invalid PE file: too small for PE header");
+        }
+
+        auto* fileHeader = reinterpret_cast<FileHeader const*>(binaryData.data() + fileHeaderOffset);
+        size_t optionalHeaderOffset = fileHeaderOffset + sizeof(FileHeader);
+        size_t sectionHeadersOffset = optionalHeaderOffset + fileHeader->sizeOfOptionalHeader;
+        size_t sectionHeadersSize = fileHeader->numberOfSections * sizeof(SectionHeader);
+        if (fileHeader->sizeOfOptionalHeader < 32 || sectionHeadersOffset + sectionHeadersSize > binaryData.size()) {
+            return geode::Err("Invalid PE file: too small for section headers");
+        }
+
+        Image image;
+        image.pointerFormat = PointerFormat::Absolute;
+
+        auto optionalHeader = binaryData.data() + optionalHeaderOffset;
+        auto optionalMagic = *reinterpret_cast<uint16_t const*>(optionalHeader);
+        if (optionalMagic == PE32_PLUS_MAGIC) {
+            image.imageBase = *reinterpret_cast<uint64_t const*>(optionalHeader + 24);
+        } else if (optionalMagic == PE32_MAGIC) {
+            image.imageBase = *reinterpret_cast<uint32_t const*>(optionalHeader + 28);
+        } else {
+            return geode::Err("Invalid PE file: unknown optional header magic");
+        }
+
+        auto* sectionHeaders = reinterpret_cast<SectionHeader const*>(binaryData.data() + sectionHeadersOffset);
+        for (uint16_t i = 0; i < fileHeader->numberOfSections; ++i) {
+            auto const& header = sectionHeaders[i];
+            size_t offset = header.pointerToRawData;
+            size_t size = header.sizeOfRawData;
+            if (header.virtualSize != 0) {
+                size = std::min<size_t>(size, header.virtualSize); // raw data is padded to file alignment
+            }
+            if (offset + size > binaryData.size()) {
+                return geode::Err(fmt::format("Invalid PE file: section {} out of bounds", i));
+            }
+
+            auto& section = image.sections.emplace_back();
+            section.name = std::string_view(header.name, strnlen(header.name, sizeof(header.name)));
+            section.address = header.virtualAddress;
+            section.data = binaryData.subspan(offset, size);
+            section.executable = (header.characteristics & IMAGE_SCN_MEM_EXECUTE) != 0;
+            section.strings = section.name == ".rdata";
+        }
+
+        if (auto pdata = image.findSection({}, ".pdata")) {
+            auto functions = reinterpret_cast<RuntimeFunction const*>(pdata->data.data());
+            size_t count = pdata->data.size() / sizeof(RuntimeFunction);
+            image.functionStarts.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                if (functions[i].beginAddress != 0) {
+                    image.functionStarts.push_back(functions[i].beginAddress);
+                }
+            }
+
+            std::ranges::sort(image.functionStarts);
+            auto [first, last] = std::ranges::unique(image.functionStarts);
+            image.functionStarts.erase(first, last);
+        }
+
+        return geode::Ok(std::move(image));
+    }
+
+    std::vector<uintptr_t> getPointerRelocations(Image const& image) {
+        std::vector<uintptr_t> relocations;
+
+        auto reloc = image.findSection({}, ".reloc");
+        if (!reloc) {
+            return relocations;
+        }
+
+        auto data = reloc->data;
+        for (size_t offset = 0; offset + sizeof(BaseRelocationBlock) <= data.size();) {
+            auto block = reinterpret_cast<BaseRelocationBlock const*>(data.data() + offset);
+            if (block->sizeOfBlock < sizeof(BaseRelocationBlock) || offset + block->sizeOfBlock > data.size()) {
+                break;
+            }
+
+            auto entries = reinterpret_cast<uint16_t const*>(block + 1);
+            size_t count = (block->sizeOfBlock - sizeof(BaseRelocationBlock)) / sizeof(uint16_t);
+            for (size_t i = 0; i < count; ++i) {
+                if (entries[i] >> 12 == IMAGE_REL_BASED_DIR64) {
+                    relocations.push_back(block->virtualAddress + (entries[i] & 0xFFF));
+                }
+            }
+
+            offset += block->sizeOfBlock;
+        }
+
+        std::ranges::sort(relocations);
+        return relocations;
+    }
+
     bool isPE64(std::span<uint8_t const> binaryData) {
         if (binaryData.size() < sizeof(DOSHeader)) {
             return false;
@@ -4,9 +4,15 @@
 #include <span>
 #include <Geode/Result.hpp>
 
+#include "Image.hpp"
+
 namespace bin::pe {
     constexpr uint16_t MZ_MAGIC = 0x5A4D; // "MZ"
     constexpr uint32_t PE_MAGIC = 0x00004550; // "PE\0\0"
+    constexpr uint16_t PE32_MAGIC = 0x10B;
+    constexpr uint16_t PE32_PLUS_MAGIC = 0x20B;
+    constexpr uint32_t IMAGE_SCN_MEM_EXECUTE = 0x20000000;
+    constexpr uint16_t IMAGE_REL_BASED_DIR64 = 10;
 
     struct DOSHeader {
         uint16_t e_magic;      // "MZ"
@@ -53,11 +59,30 @@ namespace bin::pe {
         uint32_t characteristics;
     };
 
+    struct RuntimeFunction {
+        uint32_t beginAddress;
+        uint32_t endAddress;
+        uint32_t unwindData;
+    };
+
+    struct BaseRelocationBlock {
+        uint32_t virtualAddress;
+        uint32_t sizeOfBlock;
+        // followed by uint16_t entries: type << 12 | offset
+    };
+
     struct VirtualSection {
         uintptr_t virtualAddress;
         std::span<uint8_t const> data;
     };
 
     geode::Result<VirtualSection> getSection(std::span<uint8_t const> binaryData);
+
+    /// Parses the section table, image base and .pdata function starts
+    geode::Result<Image> getImage(std::span<uint8_t const> binaryData);
+
+    /// Returns the addresses of every absolute 64-bit pointer listed in .reloc, sorted
+    std::vector<uintptr_t> getPointerRelocations(Image const& image);
+
     bool isPE64(std::span<uint8_t const> binaryData);
 }
@@ -1,77 +1,194 @@
 #include "Reader.hpp"
-#include <fstream>
+#include <JsonReader.hpp>
+#include <MappedFile.hpp>
 #include <fmt/format.h>
 #include <fmt/std.h>
-#include <nlohmann/json.hpp>
 
 namespace bromascan {
-    geode::Result<std::vector<Class>> readCodegenData(std::filesystem::path const& path) {
-        std::ifstream file(path);
-        if (!file.is_open()) {
-            return geode::Err(fmt::format("Failed to open Broma codegen data file: {}", path));
+    static std::string_view getBindingKey(Platform platform) {
+        switch (platform) {
+            case Platform::M1:
+                return "m1";
+            case Platform::IMAC:
+                return "imac";
+            case Platform::WIN:
+                return "win";
+            case Platform::IOS:
+                return "ios";
+            case Platform::ANDROID32:
+                return "android32";
+            case Platform::ANDROID64:
+                return "android64";
+            default:
+                return {};
         }
+    }
 
-        auto jsonData = nlohmann::json::parse(file, nullptr, false);
-        if (jsonData.is_discarded()) {
-            return geode::Err(fmt::format("Failed to parse Broma codegen data file: {}", path));
+    static geode::Result<Address> readAddress(utils::JsonReader& reader) {
+        if (reader.skipNull()) {
+            return geode::Ok(Address{});
         }
 
-        std::vector<Class> classes;
-        auto& jsonClasses = jsonData["classes"];
-        classes.reserve(jsonClasses.size());
-
-        for (auto& jsonClass : jsonClasses) {
-            auto& cls = classes.emplace_back();
-            cls.name = jsonClass["name"].get<std::string>();
-
-            auto& jsonFunctions = jsonClass["functions"];
-            for (auto& jsonFunction : jsonFunctions) {
-                auto& func = cls.methods.emplace_back();
-                func.name = jsonFunction["name"].get<std::string>();
-                func.returnType = jsonFunction["return"].get<std::string>();
-                func.isStatic = jsonFunction["static"].get<bool>();
-                func.isVirtual = jsonFunction["virtual"].get<bool>();
-                func.isConst = jsonFunction["const"].get<bool>();
-
-                auto& bindings = jsonFunction["bindings"];
-                auto readBinding = [&](nlohmann::json const& json) {
-                    if (json.is_null()) {
-                        return Address{};
-                    }
+        if (reader.peek() == '"') {
+            GEODE_UNWRAP_INTO(auto str, reader.readString());
+            if (str == "link") {
+                return geode::Ok(Address{0, AddressType::Link});
+            }
+            if (str == "inline") {
+                return geode::Ok(Address{0, AddressType::Inlined});
+            }
+            return geode::Ok(Address{});
+        }
 
-                    if (json.is_string()) {
-                        auto str = json.get<std::string_view>();
-                        if (str == "link") {
-                            return Address{0, AddressType::Link};
-                        }
-                        if (str == "inline") {
-                            return Address{0, AddressType::Inlined};
-                        }
-                        return Address{};
+        GEODE_UNWRAP_INTO(auto offset, reader.readInteger());
+        return geode::Ok(Address{static_cast<uintptr_t>(offset), AddressType::Offset});
+    }
+
+    geode::Result<> readArgs(utils::JsonReader& reader, FuncArgs& args) {
+        thread_local std::vector<FuncArg> parsed;
+        parsed.clear();
+
+        GEODE_UNWRAP(reader.beginArray());
+        while (true) {
+            GEODE_UNWRAP_INTO(bool hasArg, reader.nextElement());
+            if (!hasArg) break;
+
+            auto& arg = parsed.emplace_back();
+            GEODE_UNWRAP(reader.beginObject());
+            while (true) {
+                GEODE_UNWRAP_INTO(auto key, reader.nextKey());
+                if (!key) break;
+
+                if (key == "name") {
+                    GEODE_UNWRAP_INTO(arg.name, reader.readString());
+                } else if (key == "type") {
+                    GEODE_UNWRAP_INTO(arg.type, reader.readString());
+                } else {
+                    GEODE_UNWRAP(reader.skipValue());
+                }
+            }
+        }
+
+        args = storeArgs(parsed);
+        return geode::Ok();
+    }
+
+    // returns whether the function is bound to an offset on `platform`
+    static geode::Result<bool> readFunction(utils::JsonReader& reader, Platform platform, Function& func) {
+        auto bindingKey = getBindingKey(platform);
+        auto& address = getAddress(func.binding, platform);
+
+        GEODE_UNWRAP(reader.beginObject());
+        while (true) {
+            GEODE_UNWRAP_INTO(auto key, reader.nextKey());
+            if (!key) break;
+
+            if (key == "name") {
+                GEODE_UNWRAP_INTO(func.name, reader.readString());
+            } else if (key == "return") {
+                GEODE_UNWRAP_INTO(func.returnType, reader.readString());
+            } else if (key == "static") {
+                GEODE_UNWRAP_INTO(func.isStatic, reader.readBool());
+            } else if (key == "virtual") {
+                GEODE_UNWRAP_INTO(func.isVirtual, reader.readBool());
+            } else if (key == "const") {
+                GEODE_UNWRAP_INTO(func.isConst, reader.readBool());
+            } else if (key == "args") {
+                GEODE_UNWRAP(readArgs(reader, func.args));
+            } else if (key == "bindings") {
+                GEODE_UNWRAP(reader.beginObject());
+                while (true) {
+                    GEODE_UNWRAP_INTO(auto platformKey, reader.nextKey());
+                    if (!platformKey) break;
+
+                    if (platformKey == bindingKey) {
+                        GEODE_UNWRAP_INTO(address, readAddress(reader));
+                    } else {
+                        GEODE_UNWRAP(reader.skipValue());
                     }
+                }
+            } else {
+                GEODE_UNWRAP(reader.skipValue());
+            }
+        }
 
-                    return Address{
-                        json.get<uintptr_t>(),
-                        AddressType::Offset
-                    };
-                };
-
-                func.binding.windows = readBinding(bindings["win"]);
-                func.binding.macosIntel = readBinding(bindings["imac"]);
-                func.binding.macosArm = readBinding(bindings["m1"]);
-                func.binding.ios = readBinding(bindings["ios"]);
-                func.binding.android32 = readBinding(bindings["android32"]);
-                func.binding.android64 = readBinding(bindings["android64"]);
-
-                auto& jsonArgs = jsonFunction["args"];
-                for (auto& jsonArg : jsonArgs) {
-                    auto& arg = func.args.emplace_back();
-                    arg.name = jsonArg["name"].get<std::string>();
-                    arg.type = jsonArg["type"].get<std::string>();
+        return geode::Ok(address.type == AddressType::Offset);
+    }
+
+    static geode::Result<> readClass(utils::JsonReader& reader, Platform platform, Class& cls) {
+        GEODE_UNWRAP(reader.beginObject());
+        while (true) {
+            GEODE_UNWRAP_INTO(auto key, reader.nextKey());
+            if (!key) break;
+
+            if (key == "name") {
+                GEODE_UNWRAP_INTO(cls.name, reader.readString());
+                continue;
+            }
+
+            if (key != "functions") {
+                GEODE_UNWRAP(reader.skipValue());
+                continue;
+            }
+
+            GEODE_UNWRAP(reader.beginArray());
+            while (true) {
+                GEODE_UNWRAP_INTO(bool hasFunction, reader.nextElement());
+                if (!hasFunction) break;
+
+                Function func{};
+                GEODE_UNWRAP_INTO(bool isBound, readFunction(reader, platform, func));
+                if (isBound) {
+                    cls.methods.push_back(std::move(func));
                 }
             }
         }
+        return geode::Ok();
+    }
+
+    geode::Result<> readCodegenData(
+        std::filesystem::path const& path,
+        Platform platform,
+        std::function<void(Class)> const& onClass
+    ) {
+        auto file = utils::MappedFile::open(path.string());
+        if (!file) {
+            return geode::Err(fmt::format("Failed to open Broma codegen data file: {}", path));
+        }
+
+        auto data = file.unwrap().data();
+        utils::JsonReader reader({reinterpret_cast<char const*>(data.data()), data.size()});
+
+        auto parse = [&]() -> geode::Result<> {
+            GEODE_UNWRAP(reader.beginObject());
+            while (true) {
+                GEODE_UNWRAP_INTO(auto key, reader.nextKey());
+                if (!key) break;
+
+                if (key != "classes") {
+                    GEODE_UNWRAP(reader.skipValue());
+                    continue;
+                }
+
+                GEODE_UNWRAP(reader.beginArray());
+                while (true) {
+                    GEODE_UNWRAP_INTO(bool hasClass, reader.nextElement());
+                    if (!hasClass) break;
+
+                    Class cls;
+                    GEODE_UNWRAP(readClass(reader, platform, cls));
+                    if (!cls.methods.empty()) {
+                        onClass(std::move(cls));
+                    }
+                }
+            }
+            return geode::Ok();
+        };
+
+        if (auto res = parse(); !res) {
+            return geode::Err(fmt::format("Failed to parse Broma codegen data file: {}: {}", path, res.unwrapErr()));
+        }
 
-        return geode::Ok(classes);
+        return geode::Ok();
     }
 }
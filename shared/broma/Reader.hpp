@@ -1,8 +1,21 @@
 #pragma once
 #include <filesystem>
+#include <functional>
 #include <Geode/Result.hpp>
+#include <bromascan.hpp>
+#include <JsonReader.hpp>
 #include "Types.hpp"
 
 namespace bromascan {
-    geode::Result<std::vector<Class>> readCodegenData(std::filesystem::path const& path);
-}
\ No newline at end of file
+    /// Reads an `"args"` array of `{"name", "type"}` objects, shared by the codegen data and pattern files
+    geode::Result<> readArgs(utils::JsonReader& reader, FuncArgs& args);
+
+    /// Streams the codegen data and hands every class to `onClass` as soon as its object is read.
+    /// Only functions bound to an offset on `platform` are kept (with just that platform's binding),
+    /// classes left without any are skipped.
+    geode::Result<> readCodegenData(
+        std::filesystem::path const& path,
+        Platform platform,
+        std::function<void(Class)> const& onClass
+    );
+}
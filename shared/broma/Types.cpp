@@ -0,0 +1,19 @@
+#include "Types.hpp"
+
+#include <memory>
+
+#include <Arena.hpp>
+
+namespace bromascan {
+    FuncArgs storeArgs(std::span<FuncArg const> args) {
+        if (args.empty()) {
+            return {};
+        }
+
+        // an arena per thread keeps readers from contending, leaked on purpose like the string pool
+        thread_local auto arena = new utils::Arena();
+        auto storage = static_cast<FuncArg*>(arena->allocate(args.size_bytes(), alignof(FuncArg)));
+        std::uninitialized_copy(args.begin(), args.end(), storage);
+        return {storage, args.size()};
+    }
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
+#include <InternedString.hpp>
 
 namespace bromascan {
     enum class AddressType {
@@ -25,19 +27,26 @@ namespace bromascan {
         Address android64;
     };
 
+    // names and types repeat across thousands of functions, so they are interned
     struct FuncArg {
-        std::string name;
-        std::string type;
+        utils::InternedString name;
+        utils::InternedString type;
     };
 
+    /// Arguments of a function, stored in an arena that is never freed so copying a function doesn't allocate
+    using FuncArgs = std::span<FuncArg const>;
+
+    /// Copies `args` into the calling thread's argument arena
+    FuncArgs storeArgs(std::span<FuncArg const> args);
+
     struct Function {
-        std::string name;
-        std::string returnType;
-        std::vector<FuncArg> args;
+        utils::InternedString name;
+        utils::InternedString returnType;
+        FuncArgs args;
         Binding binding;
-        bool isVirtual;
-        bool isStatic;
-        bool isConst;
+        bool isVirtual = false;
+        bool isStatic = false;
+        bool isConst = false;
     };
 
     struct Class {
@@ -1,5 +1,7 @@
 #include "bromascan.hpp"
 
+#include <fmt/format.h>
+
 std::string_view format_as(Platform platform) {
     switch (platform) {
         case Platform::M1:
@@ -10,42 +12,120 @@ std::string_view format_as(Platform platform) {
             return "Windows";
         case Platform::IOS:
             return "iOS";
+        case Platform::ANDROID32:
+            return "Android32";
+        case Platform::ANDROID64:
+            return "Android64";
         default:
             return "Unknown";
     }
 }
 
+geode::Result<Platform> parsePlatform(std::string_view platform) {
+    for (auto candidate : {
+        Platform::M1, Platform::IMAC, Platform::WIN,
+        Platform::IOS, Platform::ANDROID32, Platform::ANDROID64
+    }) {
+        if (format_as(candidate) == platform) {
+            return geode::Ok(candidate);
+        }
+    }
+    return geode::Err(fmt::format("Unsupported platform: {}", platform));
+}
+
+std::string getSignature(std::string_view className, bromascan::Function const& method) {
+    auto signature = fmt::format("{}::{}(", className, method.name);
+    for (size_t i = 0; i < method.args.size(); ++i) {
+        if (i > 0) {
+            signature += ", ";
+        }
+        signature += method.args[i].type;
+    }
+    signature += method.isConst ? ") const" : ")";
+    return signature;
+}
+
 void to_json(nlohmann::json& j, MethodBinding const& mb) {
-    j["name"] = mb.method.name;
-    j["return"] = mb.method.returnType;
+    j["name"] = mb.method.name.view();
+    j["return"] = mb.method.returnType.view();
 
     auto& args = j["args"];
     args = nlohmann::json::array();
     for (auto const& arg : mb.method.args) {
         auto& jsonArg = args.emplace_back();
-        jsonArg["name"] = arg.name;
-        jsonArg["type"] = arg.type;
+        jsonArg["name"] = arg.name.view();
+        jsonArg["type"] = arg.type.view();
+    }
+
+    // only written for const methods, they are what tells overloads apart
+    if (mb.method.isConst) {
+        j["const"] = true;
     }
 
     if (mb.pattern.has_value()) {
         j["pattern"] = mb.pattern.value();
     }
 
+    if (mb.start.has_value()) {
+        j["start"] = mb.start.value();
+    }
+
+    if (mb.hash.has_value()) {
+        j["hash"] = fmt::format("{:016x}", mb.hash.value());
+    }
+
+    if (mb.estimate.has_value()) {
+        j["estimate"] = mb.estimate.value();
+    }
+
+    if (mb.cost.has_value()) {
+        auto& cost = j["cost"];
+        cost["candidates"] = mb.cost->candidates;
+        cost["compared"] = mb.cost->compared;
+    }
+
+    if (mb.caller.has_value()) {
+        auto& caller = j["caller"];
+        caller["pattern"] = mb.caller->pattern;
+        caller["index"] = mb.caller->index;
+    }
+
+    if (mb.callSite.has_value()) {
+        auto& callSite = j["callsite"];
+        callSite["pattern"] = mb.callSite->pattern;
+        callSite["offset"] = mb.callSite->offset;
+    }
+
+    if (mb.anchor.has_value()) {
+        j["anchor"] = mb.anchor.value();
+    }
+
+    if (mb.slot.has_value()) {
+        j["slot"] = mb.slot.value();
+    }
+
+    if (mb.symbol.has_value()) {
+        j["symbol"] = mb.symbol.value();
+    }
+
     if (mb.offset.has_value()) {
         j["offset"] = mb.offset.value();
     }
 }
 
 void from_json(nlohmann::json const& j, MethodBinding& mb) {
-    mb.method.name = j["name"].get<std::string>();
-    mb.method.returnType = j["return"].get<std::string>();
+    mb.method.name = j["name"].get<std::string_view>();
+    mb.method.returnType = j["return"].get<std::string_view>();
 
-    auto& jsonArgs = j["args"];
-    for (auto& jsonArg : jsonArgs) {
-        auto& arg = mb.method.args.emplace_back();
-        arg.name = jsonArg["name"].get<std::string>();
-        arg.type = jsonArg["type"].get<std::string>();
+    std::vector<bromascan::FuncArg> args;
+    for (auto& jsonArg : j["args"]) {
+        auto& arg = args.emplace_back();
+        arg.name = jsonArg["name"].get<std::string_view>();
+        arg.type = jsonArg["type"].get<std::string_view>();
     }
+    mb.method.args = bromascan::storeArgs(args);
+
+    mb.method.isConst = j.contains("const") && j["const"].get<bool>();
 
     if (j.contains("pattern") && !j["pattern"].is_null()) {
         mb.pattern = j["pattern"].get<std::string>();
@@ -53,6 +133,72 @@ void from_json(nlohmann::json const& j, MethodBinding& mb) {
         mb.pattern = std::nullopt;
     }
 
+    if (j.contains("caller") && !j["caller"].is_null()) {
+        auto& caller = j["caller"];
+        mb.caller = CallerRef{
+            caller["pattern"].get<std::string>(),
+            caller["index"].get<size_t>()
+        };
+    } else {
+        mb.caller = std::nullopt;
+    }
+
+    if (j.contains("callsite") && !j["callsite"].is_null()) {
+        auto& callSite = j["callsite"];
+        mb.callSite = CallSiteRef{
+            callSite["pattern"].get<std::string>(),
+            callSite["offset"].get<uint32_t>()
+        };
+    } else {
+        mb.callSite = std::nullopt;
+    }
+
+    if (j.contains("start") && !j["start"].is_null()) {
+        mb.start = j["start"].get<uint32_t>();
+    } else {
+        mb.start = std::nullopt;
+    }
+
+    if (j.contains("hash") && !j["hash"].is_null()) {
+        mb.hash = std::stoull(j["hash"].get<std::string>(), nullptr, 16);
+    } else {
+        mb.hash = std::nullopt;
+    }
+
+    if (j.contains("estimate") && !j["estimate"].is_null()) {
+        mb.estimate = j["estimate"].get<uint32_t>();
+    } else {
+        mb.estimate = std::nullopt;
+    }
+
+    if (j.contains("cost") && !j["cost"].is_null()) {
+        auto& cost = j["cost"];
+        mb.cost = PatternCost{
+            cost["candidates"].get<uint32_t>(),
+            cost["compared"].get<uint32_t>()
+        };
+    } else {
+        mb.cost = std::nullopt;
+    }
+
+    if (j.contains("anchor") && !j["anchor"].is_null()) {
+        mb.anchor = j["anchor"].get<std::string>();
+    } else {
+        mb.anchor = std::nullopt;
+    }
+
+    if (j.contains("slot") && !j["slot"].is_null()) {
+        mb.slot = j["slot"].get<int32_t>();
+    } else {
+        mb.slot = std::nullopt;
+    }
+
+    if (j.contains("symbol") && !j["symbol"].is_null()) {
+        mb.symbol = j["symbol"].get<std::string>();
+    } else {
+        mb.symbol = std::nullopt;
+    }
+
     if (j.contains("offset") && !j["offset"].is_null()) {
         mb.offset = j["offset"].get<uintptr_t>();
     } else {
@@ -2,21 +2,109 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <broma/Types.hpp>
+#include <Geode/Result.hpp>
 #include <nlohmann/json.hpp>
 
 enum class Platform {
     M1,
     IMAC,
     WIN,
-    IOS
+    IOS,
+    ANDROID32,
+    ANDROID64
 };
 
+enum class Architecture {
+    AArch64,
+    AMD64,
+    Thumb
+};
+
+constexpr Architecture getArchitecture(Platform platform) {
+    switch (platform) {
+        case Platform::M1:
+        case Platform::IOS:
+        case Platform::ANDROID64:
+            return Architecture::AArch64;
+        case Platform::ANDROID32:
+            return Architecture::Thumb;
+        default:
+            return Architecture::AMD64;
+    }
+}
+
+/// Alignment scanpat tries patterns at, a pattern starting anywhere else is never found
+constexpr size_t getScanStep(Architecture architecture) {
+    switch (architecture) {
+        case Architecture::AMD64:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+/// Address of a function on `platform`
+constexpr bromascan::Address const& getAddress(bromascan::Binding const& binding, Platform platform) {
+    switch (platform) {
+        case Platform::M1:
+            return binding.macosArm;
+        case Platform::IMAC:
+            return binding.macosIntel;
+        case Platform::IOS:
+            return binding.ios;
+        case Platform::ANDROID32:
+            return binding.android32;
+        case Platform::ANDROID64:
+            return binding.android64;
+        default:
+            return binding.windows;
+    }
+}
+
+constexpr bromascan::Address& getAddress(bromascan::Binding& binding, Platform platform) {
+    return const_cast<bromascan::Address&>(getAddress(std::as_const(binding), platform));
+}
+
 std::string_view format_as(Platform platform);
+/// Inverse of `format_as`
+geode::Result<Platform> parsePlatform(std::string_view platform);
+
+/// `Class::name(type, type) const`, the form demangled symbols take
+std::string getSignature(std::string_view className, bromascan::Function const& method);
+
+/// Locates a method as the `index`-th direct call made by the function matching `pattern`
+struct CallerRef {
+    std::string pattern;
+    size_t index = 0;
+};
+
+/// Locates a method through a unique pattern around one of its direct call sites,
+/// the call instruction starts `offset` bytes into `pattern` and its target is the method
+struct CallSiteRef {
+    std::string pattern;
+    uint32_t offset = 0;
+};
+
+/// Work scanpat's scan does for `pattern` over the whole segment, as measured by `genpat --verify`
+struct PatternCost {
+    uint32_t candidates = 0; // positions where the first byte matched
+    uint32_t compared = 0; // bytes compared past the first one, what `estimate` predicts
+};
 
 struct MethodBinding {
     bromascan::Function method;
     std::optional<std::string> pattern;
+    std::optional<uint32_t> start; // bytes from the function start to where `pattern` begins
+    std::optional<uint64_t> hash; // of the offset and masked code `pattern` was generated from
+    std::optional<uint32_t> estimate; // bytes scanpat is expected to compare for `pattern`, from genpat's cost model
+    std::optional<PatternCost> cost;
+    std::optional<CallerRef> caller;
+    std::optional<CallSiteRef> callSite;
+    std::optional<std::string> anchor; // unique string literal referenced by the method
+    std::optional<int32_t> slot; // vtable slot relative to the class's slot 0 method
+    std::optional<std::string> symbol; // mangled ELF symbol name
     std::optional<uintptr_t> offset;
 };
 
@@ -1,7 +1,28 @@
 #pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
 #include <fmt/format.h>
 
 namespace utils {
+    /// FNV-1a over 64-bit words (the tail byte by byte), fast enough to fingerprint a whole binary
+    inline uint64_t hashBytes(std::span<uint8_t const> data) {
+        constexpr uint64_t prime = 0x100000001b3;
+        uint64_t hash = 0xcbf29ce484222325;
+
+        size_t i = 0;
+        for (; i + 8 <= data.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data.data() + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < data.size(); ++i) {
+            hash = (hash ^ data[i]) * prime;
+        }
+
+        return hash;
+    }
+
     inline void hexdump(std::span<uint8_t const> data, size_t bytesPerLine = 16, size_t startOffset = 0) {
         for (size_t i = 0; i < data.size(); i += bytesPerLine) {
             fmt::print("{:08x}  ", i + startOffset);